@@ -0,0 +1,131 @@
+/*
+    PiCode Library
+
+    Benchmark of batch decode: an archive of pilight strings decoded one
+    decodeString() call at a time, and by decodeBatch() on the calling
+    thread and on worker pools of 1, 2, 4 up to max threads. Batch
+    results must match decodeString() ones, in input order.
+
+    Usage: bench_batch [items] [max threads]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf()                 */
+#include <stdlib.h>          /* malloc(), free(), atol() */
+#include <string.h>          /* strcmp()                 */
+#include <time.h>            /* timespec_get()           */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+#define BENCH_ITEMS   20000
+#define BENCH_THREADS 8
+
+static const char* commands[][2] = {
+  { "arctech_switch",     "{\"id\":92,\"unit\":0,\"on\":1}"                },
+  { "arctech_dimmer",     "{\"id\":92,\"unit\":0,\"dimlevel\":7}"          },
+  { "elro_800_switch",    "{\"systemcode\":17,\"unitcode\":1,\"on\":1}"    },
+  { "pollin",             "{\"systemcode\":17,\"unitcode\":1,\"off\":1}"   },
+  { "quigg_gt7000",       "{\"id\":1234,\"unit\":1,\"on\":1}"              },
+  { "rev1_switch",        "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+  { "clarus_switch",      "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+};
+
+#define N_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+/* Seconds from an arbitrary point */
+static double bench_now(void){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Compare batch results to expected ones, freeing them. Returns number of differences */
+static size_t bench_check(picode_batch_item_t* items, char** expected, size_t count){
+  size_t errors = 0;
+  for (size_t i = 0; i < count; i++) {
+    const char* result = items[i].result;
+    if ((result == NULL) != (expected[i] == NULL) || (result != NULL && strcmp(result, expected[i]) != 0)) errors++;
+    free(items[i].result);
+    items[i].result = NULL;
+  }
+  return errors;
+}
+
+int main(int argc, char** argv){
+
+  size_t               count       = (argc > 1) ? (size_t)atol(argv[1]) : BENCH_ITEMS;
+  unsigned int         max_threads = (argc > 2) ? (unsigned int)atoi(argv[2]) : BENCH_THREADS;
+  char*                strings[N_COMMANDS];
+  char**               expected    = NULL;
+  picode_batch_item_t* items       = NULL;
+  size_t               errors      = 0;
+  double               start, serial, elapsed;
+
+  if (count == 0) count = BENCH_ITEMS;
+  if (max_threads == 0) max_threads = BENCH_THREADS;
+
+  for (size_t c = 0; c < N_COMMANDS; c++) {
+    strings[c] = encodeToString(commands[c][0], commands[c][1], 1);
+    if (strings[c] == NULL) {
+      printf("ERROR: unable to encode %s\n", commands[c][0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  expected = (char**)calloc(count, sizeof(char*));
+  items    = (picode_batch_item_t*)calloc(count, sizeof(picode_batch_item_t));
+  if (expected == NULL || items == NULL) return EXIT_FAILURE;
+
+  for (size_t i = 0; i < count; i++) {
+    items[i].pilight_string = strings[i % N_COMMANDS];
+  }
+
+  // One decodeString() call per item
+  start = bench_now();
+  for (size_t i = 0; i < count; i++) {
+    expected[i] = decodeString(items[i].pilight_string);
+  }
+  serial = bench_now() - start;
+  printf("%-24s %8.2f us/item\n", "decodeString()", serial * 1e6 / (double)count);
+
+  // Batch on calling thread
+  start = bench_now();
+  decodeBatch(NULL, items, count);
+  elapsed = bench_now() - start;
+  printf("%-24s %8.2f us/item  x%.2f\n", "decodeBatch(NULL)", elapsed * 1e6 / (double)count, serial / elapsed);
+  errors += bench_check(items, expected, count);
+
+  // Batch on pools, second run reusing worker contexts is timed
+  for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+    picode_pool_t* pool = picode_pool_new(threads);
+    if (pool == NULL) {
+      printf("ERROR: unable to start %u threads\n", threads);
+      errors++;
+      break;
+    }
+    decodeBatch(pool, items, count);
+    errors += bench_check(items, expected, count);
+
+    start = bench_now();
+    decodeBatch(pool, items, count);
+    elapsed = bench_now() - start;
+    printf("decodeBatch(%2u threads)  %8.2f us/item  x%.2f\n", threads, elapsed * 1e6 / (double)count, serial / elapsed);
+    errors += bench_check(items, expected, count);
+
+    picode_pool_free(pool);
+  }
+
+  printf("%s: %zu differences from decodeString()\n", errors == 0 ? "OK" : "FAIL", errors);
+
+  for (size_t i = 0; i < count; i++) free(expected[i]);
+  free(expected);
+  free(items);
+  for (size_t c = 0; c < N_COMMANDS; c++) free(strings[c]);
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+/*
+    PiCode Library
+
+    Benchmark of decode dispatch: each frame is offered to the protocols
+    by a linear walk of the whole registry, as decodePulseTrain() did
+    before, and by the rawlen candidate list of protocol_candidates().
+    Both walks validate and parse the same way and must find the same
+    matches. Frames are encoded commands and random noise, most frames
+    on a busy band being rejected by every protocol.
+
+    Usage: bench_dispatch [rounds]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf()                 */
+#include <stdlib.h>          /* rand(), atol()           */
+#include <time.h>            /* timespec_get()           */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+#define BENCH_ROUNDS  2000
+#define BENCH_NOISE   24       /* Random frames, besides encoded ones */
+#define BENCH_PULSES  1024
+
+static const char* commands[][2] = {
+  { "arctech_switch",     "{\"id\":92,\"unit\":0,\"on\":1}"                },
+  { "arctech_dimmer",     "{\"id\":92,\"unit\":0,\"dimlevel\":7}"          },
+  { "elro_800_switch",    "{\"systemcode\":17,\"unitcode\":1,\"on\":1}"    },
+  { "pollin",             "{\"systemcode\":17,\"unitcode\":1,\"off\":1}"   },
+  { "quigg_gt7000",       "{\"id\":1234,\"unit\":1,\"on\":1}"              },
+  { "quigg_gt9000",       "{\"id\":1234,\"unit\":1,\"on\":1}"              },
+  { "rev1_switch",        "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+  { "clarus_switch",      "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+};
+
+#define N_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+#define N_FRAMES   (N_COMMANDS + BENCH_NOISE)
+
+typedef struct bench_frame_t {
+  uint32_t pulses[BENCH_PULSES];
+  uint16_t length;
+} bench_frame_t;
+
+static bench_frame_t frames[N_FRAMES];
+
+/* Seconds from an arbitrary point */
+static double bench_now(void){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Validate and parse frame with protocol like decodePulseTrain(). Returns 1 if match */
+static int bench_try(protocol_t* protocol, const bench_frame_t* frame){
+  int match = 0;
+  protocol->raw    = (uint32_t*)frame->pulses;
+  protocol->rawlen = frame->length;
+  if (protocol_validate(protocol) == 0) {
+    protocol->message = NULL;
+    protocol_parse(protocol);
+    if (protocol->message != NULL) {
+      json_delete(protocol->message);
+      protocol->message = NULL;
+      match = 1;
+    }
+  }
+  return match;
+}
+
+/* Offer frame to every registered decoding protocol. Returns number of matches */
+static int bench_linear(const bench_frame_t* frame){
+  int matches = 0;
+  for (protocols_t* node = usedProtocols(); node != NULL; node = node->next) {
+    if (node->listener->parseCode != NULL && node->listener->validate != NULL) {
+      matches += bench_try(node->listener, frame);
+    }
+  }
+  return matches;
+}
+
+/* Offer frame to candidate protocols of its length. Returns number of matches */
+static int bench_dispatch(const bench_frame_t* frame){
+  protocol_t** candidates   = NULL;
+  uint16_t     n_candidates = protocol_candidates(frame->length, &candidates);
+  int          matches      = 0;
+  for (uint16_t c = 0; c < n_candidates; c++) {
+    matches += bench_try(candidates[c], frame);
+  }
+  return matches;
+}
+
+/* Time both walks over frames first to last-1, adding their matches */
+static void bench_run(const char* name, size_t first, size_t last, long rounds, long* linear_matches, long* dispatch_matches){
+  double start, linear_time, dispatch_time;
+  double count = (double)rounds * (double)(last - first);
+
+  start = bench_now();
+  for (long r = 0; r < rounds; r++) {
+    for (size_t n = first; n < last; n++) *linear_matches += bench_linear(&frames[n]);
+  }
+  linear_time = bench_now() - start;
+
+  start = bench_now();
+  for (long r = 0; r < rounds; r++) {
+    for (size_t n = first; n < last; n++) *dispatch_matches += bench_dispatch(&frames[n]);
+  }
+  dispatch_time = bench_now() - start;
+
+  printf("%-8s linear walk %7.0f ns/frame, rawlen dispatch %7.0f ns/frame, x%.1f\n", name,
+         linear_time * 1e9 / count, dispatch_time * 1e9 / count, linear_time / dispatch_time);
+}
+
+int main(int argc, char** argv){
+
+  long   rounds  = (argc > 1) ? atol(argv[1]) : BENCH_ROUNDS;
+  int    errors  = 0;
+  long   linear_matches = 0, dispatch_matches = 0;
+
+  if (rounds <= 0) rounds = BENCH_ROUNDS;
+
+  for (size_t c = 0; c < N_COMMANDS; c++) {
+    int length = encodeToPulseTrainByName(frames[c].pulses, BENCH_PULSES, commands[c][0], commands[c][1]);
+    if (length <= 0) {
+      printf("ERROR: unable to encode %s\n", commands[c][0]);
+      return EXIT_FAILURE;
+    }
+    frames[c].length = (uint16_t)length;
+  }
+
+  srand(1);
+  for (size_t n = N_COMMANDS; n < N_FRAMES; n++) {
+    frames[n].length = (uint16_t)(10 + rand() % 400);
+    for (uint16_t p = 0; p < frames[n].length; p++) {
+      frames[n].pulses[p] = (uint32_t)(200 + rand() % 15000);
+    }
+  }
+
+  // Same matches by both walks
+  for (size_t n = 0; n < N_FRAMES; n++) {
+    if (bench_linear(&frames[n]) != bench_dispatch(&frames[n])) {
+      printf("FAIL: frame %zu of %u pulses, different matches\n", n, frames[n].length);
+      errors++;
+    }
+  }
+
+  printf("%zu frames (%zu encoded, %d noise), %ld rounds\n", (size_t)N_FRAMES, (size_t)N_COMMANDS, BENCH_NOISE, rounds);
+  bench_run("encoded", 0, N_COMMANDS, rounds, &linear_matches, &dispatch_matches);
+  bench_run("noise", N_COMMANDS, N_FRAMES, rounds, &linear_matches, &dispatch_matches);
+  bench_run("all", 0, N_FRAMES, rounds, &linear_matches, &dispatch_matches);
+
+  picode_shutdown();
+
+  return (errors == 0 && linear_matches == dispatch_matches) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
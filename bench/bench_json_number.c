@@ -0,0 +1,85 @@
+/*
+    PiCode Library
+
+    Benchmark of json number output: a message object of 32 protocol-like
+    numbers, with 0 to 2 decimals, is stringified by json_encode(). The
+    former output of each number by snprintf() "%.*f" is timed too, as
+    reference of the formatting share of the former json_encode().
+
+    Usage: bench_json_number [rounds]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf(), snprintf()     */
+#include <stdlib.h>          /* rand(), atol()           */
+#include <time.h>            /* timespec_get()           */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+#define BENCH_ROUNDS   200000
+#define BENCH_NUMBERS  32
+
+/* Seconds from an arbitrary point */
+static double bench_now(void){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv){
+
+  long      rounds  = (argc > 1) ? atol(argv[1]) : BENCH_ROUNDS;
+  double    numbers[BENCH_NUMBERS];
+  int       decimals[BENCH_NUMBERS];
+  char      key[8];
+  char      buffer[64];
+  size_t    chars   = 0;
+  double    start, reference, encode;
+  JsonNode* message = json_mkobject();
+
+  if (rounds <= 0) rounds = BENCH_ROUNDS;
+  if (message == NULL) return EXIT_FAILURE;
+
+  // Ids, units and states, temperatures, humidities and voltages
+  srand(1);
+  for (int n = 0; n < BENCH_NUMBERS; n++) {
+    decimals[n] = n % 3;
+    switch (decimals[n]) {
+      case 0:  numbers[n] = (double)(rand() % 67108864);       break;
+      case 1:  numbers[n] = (rand() % 1200 - 400) / 10.0;      break;
+      default: numbers[n] = (rand() % 500) / 100.0;            break;
+    }
+    snprintf(key, sizeof(key), "n%d", n);
+    json_append_member(message, key, json_mknumber(numbers[n], decimals[n]));
+  }
+
+  start = bench_now();
+  for (long r = 0; r < rounds; r++) {
+    for (int n = 0; n < BENCH_NUMBERS; n++) {
+      chars += (size_t)snprintf(buffer, sizeof(buffer), "%.*f", decimals[n], numbers[n]);
+    }
+  }
+  reference = bench_now() - start;
+
+  start = bench_now();
+  for (long r = 0; r < rounds; r++) {
+    char* json = json_encode(message);
+    if (json == NULL) return EXIT_FAILURE;
+    chars += json[0] == '{';
+    json_free(json);
+  }
+  encode = bench_now() - start;
+
+  printf("%d numbers, %ld rounds (%zu chars)\n", BENCH_NUMBERS, rounds, chars);
+  printf("snprintf() \"%%.*f\"       %7.1f ns/number\n", reference * 1e9 / (double)(rounds * BENCH_NUMBERS));
+  printf("json_encode() of object %7.1f ns/number\n", encode * 1e9 / (double)(rounds * BENCH_NUMBERS));
+
+  json_delete(message);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/*
+    PiCode Library
+
+    Microbenchmark of pilight string writer: random trains of 24 to 8448
+    pulses, of 3 pulse types, formatted by the former sprintf() and
+    strcat() writer, kept here as reference, by pulseTrainToString(),
+    and by pulseTrainToBuffer() into a reused buffer. Every output must
+    match the reference one.
+
+    Usage: bench_pulsetrain [pulses formatted per length]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf(), sprintf()      */
+#include <stdlib.h>          /* malloc(), free(), rand() */
+#include <string.h>          /* strcat(), strcmp()       */
+#include <stdbool.h>         /* bool                     */
+#include <time.h>            /* timespec_get()           */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+#define BENCH_PULSES  2000000  /* Pulses formatted by each writer for each length */
+#define BENCH_MAX     8448
+
+static const uint16_t lengths[] = { 24, 48, 96, 192, 384, 768, 1536, 3072, 6144, 8448 };
+
+#define N_LENGTHS (sizeof(lengths) / sizeof(lengths[0]))
+
+/* Seconds from an arbitrary point */
+static double bench_now(void){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Former pulseTrainToString(), quadratic, for up to MAX_PULSE_TYPES pulse types. Must be free() after use */
+static char* reference_to_string(const uint32_t* pulses, uint16_t maxlength, uint8_t repeats){
+
+  bool     match = false;
+  int      diff  = 0;
+  uint8_t  nrpulses                  =  0 ;
+  uint32_t plstypes[MAX_PULSE_TYPES] = {0};
+  char     pulse_str[11]             = {0};
+
+  char* data = (char*)malloc( (size_t)(2 + (maxlength) + 1 + 2 + (MAX_PULSE_TYPES*11) + 1 + (5) +  2) );
+  if (!data) return NULL;
+  strcpy(data,"c:");
+
+  for (uint16_t i = 0; i < maxlength; i++) {
+    match = false;
+    for (uint8_t j = 0; j < MAX_PULSE_TYPES; j++) {
+      diff = (int)((plstypes[j] / 50) - (pulses[i] / 50));
+      if ((diff >= -2) && (diff <= 2)) {
+        sprintf(pulse_str,"%c",(char)('0' + ((char)j)));
+        strcat(data, pulse_str );
+        match = true;
+        break;
+      }
+    }
+    if (!match) {
+      plstypes[nrpulses++] = pulses[i];
+      sprintf(pulse_str,"%c",(char)('0' + ((char)(nrpulses - 1))));
+      strcat(data, pulse_str);
+    }
+  }
+
+  strcat(data, ";p:" );
+  for (uint8_t i = 0; i < nrpulses; i++) {
+    sprintf(pulse_str, "%u", plstypes[i]);
+    strcat(data, pulse_str);
+    if (i + 1 < nrpulses) strcat(data, "," );
+  }
+  if (repeats > 0 ){
+    strcat(data, ";r:" );
+    sprintf(pulse_str, "%d", repeats);
+    strcat(data, pulse_str);
+  }
+  strcat(data, "@" );
+
+  data = (char*)realloc(data,strlen(data)+1);
+
+  return data;
+}
+
+int main(int argc, char** argv){
+
+  long      total   = (argc > 1) ? atol(argv[1]) : BENCH_PULSES;
+  uint32_t* pulses  = (uint32_t*)malloc(BENCH_MAX * sizeof(uint32_t));
+  char*     buffer  = (char*)malloc(PULSETRAIN_STRING_SIZE(BENCH_MAX));
+  int       errors  = 0;
+
+  if (total <= 0) total = BENCH_PULSES;
+  if (pulses == NULL || buffer == NULL) return EXIT_FAILURE;
+
+  printf("%6s %8s %14s %14s %14s\n", "pulses", "rounds", "reference", "ToString", "ToBuffer");
+
+  srand(1);
+  for (size_t l = 0; l < N_LENGTHS; l++) {
+
+    uint16_t length = lengths[l];
+    long     rounds = total / length;
+    double   start, reference, to_string, to_buffer;
+
+    // Short and long pulses with jitter, long footer
+    for (uint16_t p = 0; p < length - 1; p++) {
+      pulses[p] = (uint32_t)(((p % 2 == 0) ? 350 : 1050) + rand() % 60);
+    }
+    pulses[length - 1] = 10500;
+
+    char* expected = reference_to_string(pulses, length, 5);
+    char* result   = pulseTrainToString(pulses, length, 5);
+    if (expected == NULL || result == NULL || strcmp(expected, result) != 0 ||
+        pulseTrainToBuffer(pulses, length, 5, buffer, PULSETRAIN_STRING_SIZE(length)) != (int)strlen(expected) ||
+        strcmp(expected, buffer) != 0) {
+      printf("FAIL: %u pulses, output differs from reference\n", length);
+      errors++;
+    }
+    free(expected);
+    free(result);
+
+    start = bench_now();
+    for (long r = 0; r < rounds; r++) free(reference_to_string(pulses, length, 5));
+    reference = bench_now() - start;
+
+    start = bench_now();
+    for (long r = 0; r < rounds; r++) free(pulseTrainToString(pulses, length, 5));
+    to_string = bench_now() - start;
+
+    start = bench_now();
+    for (long r = 0; r < rounds; r++) pulseTrainToBuffer(pulses, length, 5, buffer, PULSETRAIN_STRING_SIZE(length));
+    to_buffer = bench_now() - start;
+
+    printf("%6u %8ld %9.1f ns/p %9.1f ns/p %9.1f ns/p\n", length, rounds,
+           reference * 1e9 / (double)(rounds * length), to_string * 1e9 / (double)(rounds * length),
+           to_buffer * 1e9 / (double)(rounds * length));
+  }
+
+  printf("%s\n", errors == 0 ? "OK" : "FAIL");
+
+  free(buffer);
+  free(pulses);
+
+  return (errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
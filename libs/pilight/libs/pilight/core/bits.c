@@ -0,0 +1,104 @@
+/*
+ 	PiCode Library https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+*/
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define BITS_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define BITS_NEON
+#endif
+
+#include "bits.h"
+
+#if defined(BITS_SSE2)
+/* Bit reversed movemask of 4 lanes, first lane to most significant bit */
+static const uint8_t rev4[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+#endif
+
+void pulsesToBits(const uint32_t *raw, unsigned int count, unsigned int stride, uint32_t threshold, uint64_t *bits) {
+	unsigned int i = 0;
+
+	memset(bits, 0, BITS_WORDS(count) * sizeof(uint64_t));
+
+	/*
+	 * Groups of 4 pulses. Strided loads read up to stride-1 pulses past
+	 * the last one of the group, so keep one more pulse behind the group.
+	 */
+#if defined(BITS_SSE2)
+	if(stride == 1 || stride == 2 || stride == 4) {
+		unsigned int last = (stride > 1) ? 1 : 0;
+		/* No unsigned compare in SSE2: flip sign bits and compare signed */
+		const __m128i bias = _mm_set1_epi32((int)0x80000000);
+		const __m128i limit = _mm_xor_si128(_mm_set1_epi32((int)threshold), bias);
+
+		for(; i + 4 + last <= count; i += 4) {
+			const uint32_t *p = raw + i * stride;
+			__m128i v;
+
+			if(stride == 1) {
+				v = _mm_loadu_si128((const __m128i *)p);
+			} else if(stride == 2) {
+				__m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)p));
+				__m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p + 4)));
+				v = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			} else {
+				__m128i a = _mm_loadu_si128((const __m128i *)p);
+				__m128i b = _mm_loadu_si128((const __m128i *)(p + 4));
+				__m128i c = _mm_loadu_si128((const __m128i *)(p + 8));
+				__m128i d = _mm_loadu_si128((const __m128i *)(p + 12));
+				v = _mm_unpacklo_epi64(_mm_unpacklo_epi32(a, b), _mm_unpacklo_epi32(c, d));
+			}
+
+			v = _mm_cmpgt_epi32(_mm_xor_si128(v, bias), limit);
+			bits[i / 64] |= (uint64_t)rev4[_mm_movemask_ps(_mm_castsi128_ps(v))] << (60 - i % 64);
+		}
+	}
+#elif defined(BITS_NEON)
+	if(stride == 1 || stride == 2 || stride == 4) {
+		unsigned int last = (stride > 1) ? 1 : 0;
+		static const uint32_t weights[4] = { 8, 4, 2, 1 };
+		const uint32x4_t w = vld1q_u32(weights);
+		const uint32x4_t limit = vdupq_n_u32(threshold);
+
+		for(; i + 4 + last <= count; i += 4) {
+			const uint32_t *p = raw + i * stride;
+			uint32x4_t v;
+
+			if(stride == 1) {
+				v = vld1q_u32(p);
+			} else if(stride == 2) {
+				v = vld2q_u32(p).val[0];
+			} else {
+				v = vld4q_u32(p).val[0];
+			}
+
+			v = vandq_u32(vcgtq_u32(v, limit), w);
+			bits[i / 64] |= (uint64_t)vaddvq_u32(v) << (60 - i % 64);
+		}
+	}
+#endif
+
+	for(; i < count; i++) {
+		if(raw[i * stride] > threshold) {
+			bits[i / 64] |= (uint64_t)1 << (63 - i % 64);
+		}
+	}
+}
+
+void bitsInvert(uint64_t *bits, unsigned int count) {
+	unsigned int i = 0;
+
+	for(i = 0; i < count / 64; i++) {
+		bits[i] = ~bits[i];
+	}
+	if(count % 64 != 0) {
+		bits[i] ^= ~(uint64_t)0 << (64 - count % 64);
+	}
+}
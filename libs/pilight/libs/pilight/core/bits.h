@@ -0,0 +1,159 @@
+/*
+ 	PiCode Library https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+    Packed bits: bit i of a buffer is bit (63 - i % 64) of word i / 64,
+    so the first bit received is the most significant of the first word.
+*/
+
+#ifndef _BITS_H_
+#define _BITS_H_
+
+#include <stdint.h>
+
+/*
+ * Number of uint64_t words needed to store n bits.
+ */
+#define BITS_WORDS(n)	(((n) + 63) / 64)
+
+/*
+ * Threshold a strided slice of pulses to packed bits, one bit per pulse:
+ * bit i is 1 if raw[i*stride] > threshold, otherwise 0.
+ * Uses SSE2 or NEON when available, with scalar fallback.
+ * Never reads beyond raw[(count-1)*stride].
+ * @param raw First pulse of the slice.
+ * @param count Number of pulses (bits) to threshold.
+ * @param stride Distance between consecutive pulses of the slice.
+ * @param threshold Pulse length threshold.
+ * @param bits Buffer of BITS_WORDS(count) words, fully overwritten.
+ */
+void pulsesToBits(const uint32_t *raw, unsigned int count, unsigned int stride, uint32_t threshold, uint64_t *bits);
+
+/*
+ * Invert the first count bits of a buffer.
+ */
+void bitsInvert(uint64_t *bits, unsigned int count);
+
+/*
+ * Reverse the order of the 64 bits of a word.
+ */
+static inline uint64_t bitsReverse(uint64_t value) {
+	value = ((value >> 1) & 0x5555555555555555ULL) | ((value & 0x5555555555555555ULL) << 1);
+	value = ((value >> 2) & 0x3333333333333333ULL) | ((value & 0x3333333333333333ULL) << 2);
+	value = ((value >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((value & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	value = ((value >> 8) & 0x00FF00FF00FF00FFULL) | ((value & 0x00FF00FF00FF00FFULL) << 8);
+	value = ((value >> 16) & 0x0000FFFF0000FFFFULL) | ((value & 0x0000FFFF0000FFFFULL) << 16);
+	return (value >> 32) | (value << 32);
+}
+
+/*
+ * Get bit i of a buffer, 0 or 1.
+ */
+static inline int bitsGet(const uint64_t *bits, unsigned int i) {
+	return (int)((bits[i / 64] >> (63 - i % 64)) & 1);
+}
+
+/*
+ * Convert bits[s(msb) .. e(lsb)] to its value. 0<=s<=e, e-s < 64
+ */
+static inline unsigned long long bitsToDecRev(const uint64_t *bits, unsigned int s, unsigned int e) {
+	unsigned int n = e - s + 1, w = s / 64, o = s % 64;
+	uint64_t value = bits[w] << o;
+	if(o + n > 64)
+		value |= bits[w + 1] >> (64 - o);
+	return value >> (64 - n);
+}
+
+/*
+ * Convert bits[s(lsb) .. e(msb)] to its value. 0<=s<=e, e-s < 64
+ */
+static inline unsigned long long bitsToDec(const uint64_t *bits, unsigned int s, unsigned int e) {
+	return bitsReverse(bitsToDecRev(bits, s, e)) >> (64 - (e - s + 1));
+}
+
+/*
+ * Convert bits[s(msb) .. e(lsb)] to its signed two's complement value. 0<=s<=e, e-s < 32
+ */
+static inline int bitsToSignedRev(const uint64_t *bits, unsigned int s, unsigned int e) {
+	int result = (int)bitsToDecRev(bits, s, e);
+	if(bitsGet(bits, s)) {
+		result -= 1<<(e-s+1);
+	}
+	return result;
+}
+
+/*
+ * Convert bits[s(lsb) .. e(msb)] to its signed two's complement value. 0<=s<=e, e-s < 32
+ */
+static inline int bitsToSigned(const uint64_t *bits, unsigned int s, unsigned int e) {
+	int result = (int)bitsToDec(bits, s, e);
+	if(bitsGet(bits, e)) {
+		result -= 1<<(e-s+1);
+	}
+	return result;
+}
+
+/*
+ * Set bit i of a buffer to value, 0 or 1.
+ */
+static inline void bitsSet(uint64_t *bits, unsigned int i, int value) {
+	uint64_t mask = (uint64_t)1 << (63 - i % 64);
+	bits[i / 64] = value ? (bits[i / 64] | mask) : (bits[i / 64] & ~mask);
+}
+
+/*
+ * Store value in bits[s(msb) .. e(lsb)], other bits are kept. 0<=s<=e, e-s < 64
+ */
+static inline void bitsFromDecRev(uint64_t *bits, unsigned int s, unsigned int e, unsigned long long value) {
+	unsigned int n = e - s + 1, w = s / 64, o = s % 64;
+	uint64_t mask = ~(uint64_t)0 >> (64 - n);
+	value = (value & mask) << (64 - n);
+	mask <<= 64 - n;
+	bits[w] = (bits[w] & ~(mask >> o)) | (value >> o);
+	if(o + n > 64) {
+		bits[w + 1] = (bits[w + 1] & ~(mask << (64 - o))) | (value << (64 - o));
+	}
+}
+
+/*
+ * Store value in bits[s(lsb) .. e(msb)], other bits are kept. 0<=s<=e, e-s < 64
+ */
+static inline void bitsFromDec(uint64_t *bits, unsigned int s, unsigned int e, unsigned long long value) {
+	bitsFromDecRev(bits, s, e, bitsReverse(value) >> (64 - (e - s + 1)));
+}
+
+/*
+ * Convert a value to its bits from index 0, without leading zeros.
+ * decToBitsUl() stores bits[msb .. lsb] and returns the index of the lsb,
+ * decToBitsRevUl() stores bits[lsb .. msb] and returns the index of the msb.
+ * At least one bit is generated. bits must hold one word.
+ */
+static inline int decToBitsUl(unsigned long long dec, uint64_t *bits) {
+	int length = 1;
+	while(length < 64 && (dec >> length) != 0) {
+		length++;
+	}
+	bits[0] = (uint64_t)dec << (64 - length);
+	return length - 1;
+}
+
+static inline int decToBitsRevUl(unsigned long long dec, uint64_t *bits) {
+	int last = decToBitsUl(dec, bits);
+	bits[0] = bitsReverse(dec);
+	return last;
+}
+
+/*
+ * Dito for int values, dec is taken as unsigned int.
+ */
+static inline int decToBits(int dec, uint64_t *bits) {
+	return decToBitsUl((unsigned int)dec, bits);
+}
+
+static inline int decToBitsRev(int dec, uint64_t *bits) {
+	return decToBitsRevUl((unsigned int)dec, bits);
+}
+
+#endif
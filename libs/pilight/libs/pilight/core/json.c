@@ -26,6 +26,7 @@
 */
 
 #include <assert.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -39,10 +40,146 @@
 		exit(EXIT_FAILURE);                     \
 	} while (0)
 
+#if defined(_MSC_VER)
+	#define JSON_THREAD_LOCAL __declspec(thread)
+#else
+	#define JSON_THREAD_LOCAL _Thread_local
+#endif
+
+/* Arena */
+
+/* Node fields allocated from an arena, left to it by json_delete() */
+#define JSON_ARENA_NODE		0x01
+#define JSON_ARENA_KEY		0x02
+#define JSON_ARENA_STRING	0x04
+
+#define JSON_ARENA_BLOCK_SIZE	4096
+#define JSON_ARENA_ALIGN(size)	(((size) + 15) & ~(size_t)15)
+
+typedef struct JsonArenaBlock
+{
+	struct JsonArenaBlock *next;
+	size_t size;
+	size_t used;
+} JsonArenaBlock;
+
+#define JSON_ARENA_DATA(block)	((char*)(block) + JSON_ARENA_ALIGN(sizeof(JsonArenaBlock)))
+
+struct JsonArena
+{
+	JsonArenaBlock *head;
+	JsonArenaBlock *current;
+	size_t block_size;
+
+	/* String parse buffer, kept across resets */
+	char *scratch;
+	size_t scratch_size;
+};
+
+/* Arena of calling thread, NULL to allocate from heap */
+static JSON_THREAD_LOCAL JsonArena *json_arena_current = NULL;
+
+static JsonArenaBlock *arena_block(size_t size)
+{
+	JsonArenaBlock *block = (JsonArenaBlock*) MALLOC(JSON_ARENA_ALIGN(sizeof(JsonArenaBlock)) + size);
+	if (block == NULL)
+		out_of_memory(); /*LCOV_EXCL_LINE*/
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
+
+static void *arena_alloc(JsonArena *arena, size_t size)
+{
+	JsonArenaBlock *block = arena->current;
+	void *ret;
+
+	size = JSON_ARENA_ALIGN(size);
+
+	if (block->size - block->used < size) {
+		if (block->next != NULL && block->next->size >= size) {
+			block = block->next;
+		} else {
+			JsonArenaBlock *added = arena_block(size > arena->block_size ? size : arena->block_size);
+			added->next = block->next;
+			block->next = added;
+			block = added;
+		}
+		arena->current = block;
+	}
+
+	ret = JSON_ARENA_DATA(block) + block->used;
+	block->used += size;
+	return ret;
+}
+
+JsonArena *json_arena_new(size_t block_size)
+{
+	JsonArena *arena = (JsonArena*) MALLOC(sizeof(JsonArena));
+	if (arena == NULL)
+		return NULL;
+
+	arena->block_size = JSON_ARENA_ALIGN(block_size > 0 ? block_size : JSON_ARENA_BLOCK_SIZE);
+	arena->head = arena_block(arena->block_size);
+	arena->current = arena->head;
+	arena->scratch_size = 64;
+	arena->scratch = (char*) MALLOC(arena->scratch_size + 1);
+	if (arena->scratch == NULL)
+		out_of_memory(); /*LCOV_EXCL_LINE*/
+	return arena;
+}
+
+void json_arena_reset(JsonArena *arena)
+{
+	JsonArenaBlock *block;
+
+	if (arena == NULL)
+		return;
+
+	for (block = arena->head; block != NULL; block = block->next)
+		block->used = 0;
+	arena->current = arena->head;
+}
+
+void json_arena_free(JsonArena *arena)
+{
+	JsonArenaBlock *block, *next;
+
+	if (arena == NULL)
+		return;
+
+	if (json_arena_current == arena)
+		json_arena_current = NULL;
+
+	for (block = arena->head; block != NULL; block = next) {
+		next = block->next;
+		FREE(block);
+	}
+	FREE(arena->scratch);
+	FREE(arena);
+}
+
+JsonArena *json_arena_use(JsonArena *arena)
+{
+	JsonArena *previous = json_arena_current;
+	json_arena_current = arena;
+	return previous;
+}
+
 /* Sadly, strdup is not portable. */
 static char *json_strdup(const char *str)
 {
-	char *ret = (char*) MALLOC(strlen(str) + 1);
+	char *ret;
+
+	if (json_arena_current != NULL) {
+		size_t size = strlen(str) + 1;
+		ret = (char*) arena_alloc(json_arena_current, size);
+		memcpy(ret, str, size);
+		return ret;
+	}
+
+	ret = (char*) MALLOC(strlen(str) + 1);
 	if (ret == NULL)
 		out_of_memory(); /*LCOV_EXCL_LINE*/
 	memset(ret, 0, strlen(str) + 1);
@@ -121,6 +258,49 @@ static void sb_free(SB *sb)
 	FREE(sb->start);
 }
 
+/* Parsed strings are built in arena scratch buffer, if any */
+static void str_init(SB *sb)
+{
+	JsonArena *arena = json_arena_current;
+
+	if (arena == NULL) {
+		sb_init(sb);
+		return;
+	}
+	sb->start = arena->scratch;
+	sb->cur = sb->start;
+	sb->end = sb->start + arena->scratch_size;
+}
+
+static char *str_finish(SB *sb)
+{
+	JsonArena *arena = json_arena_current;
+	char *ret;
+
+	if (arena == NULL)
+		return sb_finish(sb);
+
+	arena->scratch = sb->start;
+	arena->scratch_size = sb->end - sb->start;
+
+	ret = (char*) arena_alloc(arena, sb->cur - sb->start + 1);
+	memcpy(ret, sb->start, sb->cur - sb->start);
+	ret[sb->cur - sb->start] = 0;
+	return ret;
+}
+
+static void str_free(SB *sb)
+{
+	JsonArena *arena = json_arena_current;
+
+	if (arena == NULL) {
+		sb_free(sb);
+		return;
+	}
+	arena->scratch = sb->start;
+	arena->scratch_size = sb->end - sb->start;
+}
+
 /*
  * Unicode helper functions
  *
@@ -418,7 +598,8 @@ void json_delete(JsonNode *node)
 
 		switch (node->tag) {
 			case JSON_STRING:
-				FREE(node->string_);
+				if (!(node->arena_ & JSON_ARENA_STRING))
+					FREE(node->string_);
 				break;
 			case JSON_ARRAY:
 			case JSON_OBJECT:
@@ -433,7 +614,8 @@ void json_delete(JsonNode *node)
 			default:;
 		}
 
-		FREE(node);
+		if (!(node->arena_ & JSON_ARENA_NODE))
+			FREE(node);
 	}
 }
 
@@ -494,7 +676,17 @@ JsonNode *json_first_child(const JsonNode *node)
 
 static JsonNode *mknode(JsonTag tag)
 {
-	JsonNode *ret = (JsonNode*) CALLOC(1, sizeof(JsonNode));
+	JsonNode *ret;
+
+	if (json_arena_current != NULL) {
+		ret = (JsonNode*) arena_alloc(json_arena_current, sizeof(JsonNode));
+		memset(ret, 0, sizeof(JsonNode));
+		ret->arena_ = JSON_ARENA_NODE;
+		ret->tag = tag;
+		return ret;
+	}
+
+	ret = (JsonNode*) CALLOC(1, sizeof(JsonNode));
 	if (ret == NULL)
 		out_of_memory(); /*LCOV_EXCL_LINE*/
 	ret->tag = tag;
@@ -517,6 +709,8 @@ static JsonNode *mkstring(char *s)
 {
 	JsonNode *ret = mknode(JSON_STRING);
 	ret->string_ = s;
+	if (json_arena_current != NULL)
+		ret->arena_ |= JSON_ARENA_STRING;
 	return ret;
 }
 
@@ -569,9 +763,18 @@ static void prepend_node(JsonNode *parent, JsonNode *child)
 	parent->children.head = child;
 }
 
+static void set_key(JsonNode *node, char *key)
+{
+	node->key = key;
+	if (json_arena_current != NULL)
+		node->arena_ |= JSON_ARENA_KEY;
+	else
+		node->arena_ &= ~JSON_ARENA_KEY;
+}
+
 static void append_member(JsonNode *object, char *key, JsonNode *value)
 {
-	value->key = key;
+	set_key(value, key);
 	append_node(object, value);
 }
 
@@ -604,7 +807,7 @@ void json_prepend_member(JsonNode *object, const char *key, JsonNode *value)
 	assert(object->tag == JSON_OBJECT);
 	assert(value->parent == NULL);
 
-	value->key = json_strdup(key);
+	set_key(value, json_strdup(key));
 	prepend_node(object, value);
 }
 
@@ -622,7 +825,7 @@ void json_remove_from_parent(JsonNode *node)
 		else
 			parent->children.tail = node->prev;
 
-		if(node->key != NULL) {
+		if(node->key != NULL && !(node->arena_ & JSON_ARENA_KEY)) {
 			FREE(node->key);
 		}
 
@@ -796,7 +999,7 @@ success:
 	return true;
 
 failure_free_key:
-	if (out)
+	if (out && json_arena_current == NULL)
 		FREE(key);
 failure:
 	json_delete(ret);
@@ -815,7 +1018,7 @@ bool parse_string(const char **sp, char **out)
 		return false;
 
 	if (out) {
-		sb_init(&sb);
+		str_init(&sb);
 		sb_need(&sb, 4);
 		b = sb.cur;
 	} else {
@@ -908,13 +1111,13 @@ bool parse_string(const char **sp, char **out)
 	s++;
 
 	if (out)
-		*out = sb_finish(&sb);
+		*out = str_finish(&sb);
 	*sp = s;
 	return true;
 
 failed:
 	if (out)
-		sb_free(&sb);
+		str_free(&sb);
 	return false;
 }
 
@@ -1265,6 +1468,66 @@ void emit_string(SB *out, const char *str)
 	out->cur = b;
 }
 
+/*
+ * Format num with up to 9 decimals as "%.*f" does, without printf.
+ * The scaled value is rounded to nearest, and numbers too large or
+ * too close to half way for the scaling error are left to printf.
+ * Returns the length written to buf, 0 if left to printf.
+ */
+static int format_fixed(char *buf, double num, int decimals)
+{
+	static const double scales[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+	};
+	char digits[24];
+	double scaled, frac;
+	uint64_t value, integer, fraction, scale = 1;
+	int i, n = 0, len = 0;
+
+	if (decimals < 0 || decimals > 9 || !isfinite(num))
+		return 0;
+
+	scaled = fabs(num) * scales[decimals];
+	if (scaled >= 1e15)
+		return 0;
+
+	value = (uint64_t)scaled;
+	frac = scaled - (double)value;
+	if (fabs(frac - 0.5) <= scaled * 1e-15)
+		return 0;
+	if (frac > 0.5)
+		value++;
+
+	for (i = 0; i < decimals; i++)
+		scale *= 10;
+
+	if (signbit(num))
+		buf[len++] = '-';
+
+	/* Integer part */
+	integer = value / scale;
+	do {
+		digits[n++] = (char)('0' + integer % 10);
+		integer /= 10;
+	} while (integer > 0);
+	while (n > 0)
+		buf[len++] = digits[--n];
+
+	/* Fractional part, zero padded */
+	if (decimals > 0) {
+		fraction = value % scale;
+		buf[len++] = '.';
+		for (i = decimals - 1; i >= 0; i--) {
+			buf[len + i] = (char)('0' + fraction % 10);
+			fraction /= 10;
+		}
+		len += decimals;
+	}
+
+	buf[len] = 0;
+	return len;
+}
+
 static void emit_number(SB *out, double num, int decimals)
 {
 	/*
@@ -1274,9 +1537,15 @@ static void emit_number(SB *out, double num, int decimals)
 	 * like 0.3 -> 0.299999999999999988898 .
 	 */
 	char buf[64];
-	sprintf(buf, "%.*f", decimals, num);
+	int len = format_fixed(buf, num, decimals);
+
+	if (len > 0) {
+		sb_put(out, buf, len);
+		return;
+	}
 
-	if (number_is_valid(buf))
+	/* Numbers not fitting buf were overflowing it */
+	if (snprintf(buf, sizeof(buf), "%.*f", decimals, num) < (int)sizeof(buf) && number_is_valid(buf))
 		sb_puts(out, buf);
 	else
 		sb_puts(out, "null");
@@ -66,6 +66,9 @@ struct JsonNode
 		} children;
 	};
 	int decimals_;
+
+	/* Fields allocated from an arena (see json_arena_use) */
+	unsigned char arena_;
 };
 
 /*** Encoding, decoding, and validation ***/
@@ -108,6 +111,22 @@ void json_remove_from_parent(JsonNode *node);
 
 void json_free(void *a);
 
+/*** Arena allocation ***/
+
+/*
+ * Nodes, keys and strings built by a thread while an arena is in use are
+ * allocated from that arena, and json_delete() leaves them to it. Resetting
+ * or freeing the arena releases them all at once, so no tree built in it may
+ * be used afterwards. json_arena_use() sets the arena of the calling thread,
+ * NULL for heap allocation, and returns the previous one.
+ */
+typedef struct JsonArena JsonArena;
+
+JsonArena *json_arena_new   (size_t block_size);
+void       json_arena_reset (JsonArena *arena);
+void       json_arena_free  (JsonArena *arena);
+JsonArena *json_arena_use   (JsonArena *arena);
+
 /*** Debugging ***/
 
 /*
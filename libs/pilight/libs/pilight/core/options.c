@@ -14,6 +14,7 @@
 #endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "log.h"
@@ -22,7 +23,41 @@
 #include "options.h"
 #include "json.h"
 
+#if defined(_MSC_VER)
+	#define OPTIONS_THREAD_LOCAL __declspec(thread)
+#else
+	#define OPTIONS_THREAD_LOCAL _Thread_local
+#endif
+
+/* Nodes added by options_add() are taken from a static pool, enough for
+   all protocol options, and from heap once it is full. Protocol options
+   are added once for all threads and never changed, so the pool is shared
+   and threads registering protocols again skip options_add() */
+#define OPTIONS_POOL_SIZE 512
+
+static struct options_t options_pool[OPTIONS_POOL_SIZE];
+static int options_pool_used = 0;
+static OPTIONS_THREAD_LOCAL int options_skipped = 0;
+
+static struct options_t *options_node(void) {
+	if(options_pool_used < OPTIONS_POOL_SIZE) {
+		return &options_pool[options_pool_used++];
+	}
+	return MALLOC(sizeof(struct options_t));
+}
+
+static int options_pooled(const struct options_t *node) {
+	return (uintptr_t)node >= (uintptr_t)&options_pool[0] && (uintptr_t)node < (uintptr_t)&options_pool[OPTIONS_POOL_SIZE];
+}
+
+/* Skip options_add() calls of calling thread while skip is set */
+void options_skip(int skip) {
+	options_skipped = skip;
+}
+
+/* Rewind shared pool, options of all threads must be options_delete() before */
 int options_gc(void) {
+	options_pool_used = 0;
 	logprintf(LOG_DEBUG, "garbage collected options library");
 	return EXIT_SUCCESS;
 }
@@ -514,70 +549,49 @@ int options_parse(struct options_t *opt, int argc, char **argv, int error_check)
 }
 
 /* Add a new option to the options struct */
+/* Id, name and mask are referenced, not copied: they must be string literals */
 void options_add(struct options_t **opt, char *id, const char *name, int argtype, int conftype, int vartype, void *def, const char *mask) {
 
 	char *ctmp = NULL;
-	char *nname = MALLOC(strlen(name)+1);
 	char *sid = NULL;
-	if(nname == NULL) {
-		OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
-	}
-	strcpy(nname, name);
 	int itmp = 0;
-	if(!(argtype >= 0 && argtype <= 3)) {
+	if(options_skipped) {
+		return;
+	} else if(!(argtype >= 0 && argtype <= 3)) {
 		logprintf(LOG_CRIT, "tying to add an invalid option type");
-		FREE(nname);
 		exit(EXIT_FAILURE);
 	} else if(!(conftype >= 0 && conftype <= NROPTIONTYPES)) {
 		logprintf(LOG_CRIT, "trying to add an option of an invalid type");
-		FREE(nname);
 		exit(EXIT_FAILURE);
 	} else if(!name) {
 		logprintf(LOG_CRIT, "trying to add an option without name");
-		FREE(nname);
 		exit(EXIT_FAILURE);
 	} else if(id == NULL) {
 		logprintf(LOG_CRIT, "option id cannot be null: %s", name);
-		FREE(nname);
 	} else if(options_get_name(*opt, id, &ctmp) == 0) {
 		logprintf(LOG_CRIT, "duplicate option id: %s", id);
-		FREE(nname);
 		exit(EXIT_FAILURE);
-	} else if(options_get_id(*opt, nname, &sid) == 0 &&
+	} else if(options_get_id(*opt, (char *)name, &sid) == 0 &&
 			((options_get_conftype(*opt, sid, 0, &itmp) == 0 && itmp == conftype) ||
 			(options_get_conftype(*opt, sid, 0, &itmp) != 0))) {
 		logprintf(LOG_CRIT, "duplicate option name: %s", name);
-		FREE(nname);
 		exit(EXIT_FAILURE);
 	} else {
-		struct options_t *optnode = MALLOC(sizeof(struct options_t));
+		struct options_t *optnode = options_node();
 		if(optnode == NULL) {
 			OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
 		}
-		if((optnode->id = STRDUP(id)) == NULL) {
-			OUT_OF_MEMORY
-		}
-		if((optnode->name = MALLOC(strlen(name)+1)) == NULL) {
-			OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
-		}
-		strcpy(optnode->name, name);
+		optnode->id = id;
+		optnode->name = (char *)name;
 		optnode->argtype = argtype;
 		optnode->conftype = conftype;
 		optnode->vartype = vartype;
 		optnode->def = def;
 		optnode->string_ = NULL;
 		optnode->set = 0;
-		if(mask) {
-			if((optnode->mask = MALLOC(strlen(mask)+1)) == NULL) {
-				OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
-			}
-			strcpy(optnode->mask, mask);
-		} else {
-			optnode->mask = NULL;
-		}
+		optnode->mask = (char *)mask;
 		optnode->next = *opt;
 		*opt = optnode;
-		FREE(nname);
 	}
 }
 
@@ -591,18 +605,9 @@ void options_merge(struct options_t **a, struct options_t **b) {
 		if(optnode == NULL) {
 			OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
 		}
-		if((optnode->id = STRDUP(temp->id)) == NULL) {
-			OUT_OF_MEMORY
-		}
-		if(temp->name) {
-			if((optnode->name = MALLOC(strlen(temp->name)+1)) == NULL) {
-				OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
-			}
-			memset(optnode->name, '\0', strlen(temp->name)+1);
-			strcpy(optnode->name, temp->name);
-		} else {
-			optnode->name = NULL;
-		}
+		/* Id, name and mask are string literals shared with b */
+		optnode->id = temp->id;
+		optnode->name = temp->name;
 		if(temp->string_) {
 			if((optnode->string_ = MALLOC(strlen(temp->string_)+1)) == NULL) {
 				OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
@@ -612,14 +617,7 @@ void options_merge(struct options_t **a, struct options_t **b) {
 		} else {
 			optnode->string_ = NULL;
 		}
-		if(temp->mask) {
-			if((optnode->mask = MALLOC(strlen(temp->mask)+1)) == NULL) {
-				OUT_OF_MEMORY /*LCOV_EXCL_LINE*/
-			}
-			strcpy(optnode->mask, temp->mask);
-		} else {
-			optnode->mask = NULL;
-		}
+		optnode->mask = temp->mask;
 		optnode->argtype = temp->argtype;
 		optnode->conftype = temp->conftype;
 		optnode->vartype = temp->vartype;
@@ -649,20 +647,13 @@ void options_delete(struct options_t *options) {
 	struct options_t *tmp;
 	while(options) {
 		tmp = options;
-		if(tmp->mask) {
-			FREE(tmp->mask);
-		}
 		if(tmp->vartype == JSON_STRING && tmp->string_ != NULL) {
 			FREE(tmp->string_);
 		}
-		if(tmp->id != NULL) {
-			FREE(tmp->id);
-		}
-		if(tmp->name != NULL) {
-			FREE(tmp->name);
-		}
 		options = options->next;
-		FREE(tmp);
+		if(!options_pooled(tmp)) {
+			FREE(tmp);
+		}
 	}
 	if(options != NULL) {
 		FREE(options);
@@ -39,6 +39,7 @@ typedef struct options_t {
 } options_t;
 
 int options_gc(void);
+void options_skip(int skip);
 void options_set_string(struct options_t *options, char *id, const char *val);
 void options_set_number(struct options_t *options, char *id, int val);
 void options_set_null(struct options_t *options, char *id);
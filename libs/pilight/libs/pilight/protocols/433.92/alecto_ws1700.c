@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "alecto_ws1700.h"
 
@@ -43,7 +43,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(alecto_ws1700->rawlen == RAW_LENGTH) {
@@ -57,7 +57,7 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = 0, battery = 0, header = 0;
 	double humi_offset = 0.0, temp_offset = 0.0;
 	double temperature = 0.0, humidity = 0.0;
@@ -67,22 +67,16 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<alecto_ws1700->rawlen-1;x+=2) {
-		if(alecto_ws1700->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&alecto_ws1700->raw[1], (alecto_ws1700->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	header = binToDecRev(binary, 0, 3);
+	header = bitsToDecRev(binary, 0, 3);
 	if (header != 5) {
 		return;
 	}
-	id = binToDecRev(binary, 4, 11);
-	battery = binary[12];
-	temperature = (double)binToSignedRev(binary, 16, 27);
-	humidity = (double)binToDecRev(binary, 28, 35);
+	id = bitsToDecRev(binary, 4, 11);
+	battery = bitsGet(binary, 12);
+	temperature = (double)bitsToSignedRev(binary, 16, 27);
+	humidity = (double)bitsToDecRev(binary, 28, 35);
 
 	temperature /= 10;
 
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *alecto_ws1700;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *alecto_ws1700;
 void alectoWS1700Init(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "alecto_wsd17.h"
 
@@ -42,7 +42,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(alecto_wsd17->rawlen == RAW_LENGTH) {
@@ -56,7 +56,8 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, id = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
+	int id = 0;
 	double temp_offset = 0.0, temperature = 0.0;
 
 	if(alecto_wsd17->rawlen>RAW_LENGTH) {
@@ -64,16 +65,10 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<alecto_wsd17->rawlen-1;x+=2) {
-		if(alecto_wsd17->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&alecto_wsd17->raw[1], (alecto_wsd17->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	id = binToDecRev(binary, 0, 11);
-	temperature = binToDecRev(binary, 16, 27);
+	id = bitsToDecRev(binary, 0, 11);
+	temperature = bitsToDecRev(binary, 16, 27);
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *alecto_wsd17;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *alecto_wsd17;
 void alectoWSD17Init(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "alecto_wx500.h"
 //
@@ -48,7 +48,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(alecto_wx500->rawlen == RAW_LENGTH) {
@@ -61,7 +61,8 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, type = 0, id = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
+	int type = 0, id = 0;
 	double temp_offset = 0.0, humi_offset = 0.0;
 	double humidity = 0.0, temperature = 0.0;
 	int winddir = 0, windavg = 0, windgust = 0;
@@ -75,23 +76,17 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<alecto_wx500->rawlen;x+=2) {
-		if(alecto_wx500->raw[x] > AVG_PULSE) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&alecto_wx500->raw[1], alecto_wx500->rawlen/2, 2, AVG_PULSE, binary);
 
-	n8=binToDec(binary, 32, 35);
-	n7=binToDec(binary, 28, 31);
-	n6=binToDec(binary, 24, 27);
-	n5=binToDec(binary, 20, 23);
-	n4=binToDec(binary, 16, 19);
-	n3=binToDec(binary, 12, 15);
-	n2=binToDec(binary, 8, 11);
-	n1=binToDec(binary, 4, 7);
-	n0=binToDec(binary, 0, 3);
+	n8=bitsToDec(binary, 32, 35);
+	n7=bitsToDec(binary, 28, 31);
+	n6=bitsToDec(binary, 24, 27);
+	n5=bitsToDec(binary, 20, 23);
+	n4=bitsToDec(binary, 16, 19);
+	n3=bitsToDec(binary, 12, 15);
+	n2=bitsToDec(binary, 8, 11);
+	n1=bitsToDec(binary, 4, 7);
+	n0=bitsToDec(binary, 0, 3);
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -143,10 +138,10 @@ static void parseCode(void) {
 	alecto_wx500->message = json_mkobject();
 	switch(type) {
 		case 1:
-			id = binToDec(binary, 0, 7);
-			temperature = (double)(binToSigned(binary, 12, 23)) / 10.0;
-			humidity = (binToDec(binary, 28, 31) * 10) + binToDec(binary, 24,27);
-			battery = !binary[8];
+			id = bitsToDec(binary, 0, 7);
+			temperature = (double)(bitsToSigned(binary, 12, 23)) / 10.0;
+			humidity = (bitsToDec(binary, 28, 31) * 10) + bitsToDec(binary, 24,27);
+			battery = !bitsGet(binary, 8);
 
 			temperature += temp_offset;
 			humidity += humi_offset;
@@ -157,19 +152,19 @@ static void parseCode(void) {
 			json_append_member(alecto_wx500->message, "battery", json_mknumber(battery, 0));
 		break;
 		case 2:
-			id = binToDec(binary, 0, 7);
-			windavg = binToDec(binary, 24, 31) * 2;
-			battery = !binary[8];
+			id = bitsToDec(binary, 0, 7);
+			windavg = bitsToDec(binary, 24, 31) * 2;
+			battery = !bitsGet(binary, 8);
 
 			json_append_member(alecto_wx500->message, "id", json_mknumber(id, 0));
 			json_append_member(alecto_wx500->message, "windavg", json_mknumber((double)windavg/10, 1));
 			json_append_member(alecto_wx500->message, "battery", json_mknumber(battery, 0));
 		break;
 		case 3:
-			id = binToDec(binary, 0, 7);
-			winddir = binToDec(binary, 15, 23);
-			windgust = binToDec(binary, 24, 31) * 2;
-			battery = !binary[8];
+			id = bitsToDec(binary, 0, 7);
+			winddir = bitsToDec(binary, 15, 23);
+			windgust = bitsToDec(binary, 24, 31) * 2;
+			battery = !bitsGet(binary, 8);
 
 			json_append_member(alecto_wx500->message, "id", json_mknumber(id, 0));
 			json_append_member(alecto_wx500->message, "winddir", json_mknumber((double)winddir, 0));
@@ -177,9 +172,9 @@ static void parseCode(void) {
 			json_append_member(alecto_wx500->message, "battery", json_mknumber(battery, 0));
 		break;
 		case 4:
-			id = binToDec(binary, 0, 7);
-			/*rain = binToDec(binary, 16, 30) * 5;*/
-			battery = !binary[8];
+			id = bitsToDec(binary, 0, 7);
+			/*rain = bitsToDec(binary, 16, 30) * 5;*/
+			battery = !bitsGet(binary, 8);
 			//json_append_member(alecto_wx500->message, "rain", json_mknumber((double)rain/10, 1));
 			json_append_member(alecto_wx500->message, "id", json_mknumber(id, 0));
 			json_append_member(alecto_wx500->message, "battery", json_mknumber(battery, 0));
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *alecto_wx500;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *alecto_wx500;
 void alectoWX500Init(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "arctech_dimmer.h"
 
@@ -82,29 +82,23 @@ static void createMessage(int id, int unit, int state, int all, int dimlevel, in
 }
 
 static void parseCode(void) {
-	int binary[MAX_RAW_LENGTH/4], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(MAX_RAW_LENGTH/4)];
 
 	if(arctech_dimmer->rawlen>MAX_RAW_LENGTH) {
 		logprintf(LOG_ERR, "arctech_dimmer: parsecode - invalid parameter passed %d", arctech_dimmer->rawlen);
 		return;
 	}
 
-	for(x=0;x<arctech_dimmer->rawlen;x+=4) {
-		if(arctech_dimmer->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&arctech_dimmer->raw[3], (arctech_dimmer->rawlen+3)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
 	int dimlevel = -1;
 	if(arctech_dimmer->rawlen == MAX_RAW_LENGTH) {
-		dimlevel = binToDecRev(binary, 32, 35);
+		dimlevel = bitsToDecRev(binary, 32, 35);
 	}
-	int unit = binToDecRev(binary, 28, 31);
-	int state = binary[27];
-	int all = binary[26];
-	int id = binToDecRev(binary, 0, 25);
+	int unit = bitsToDecRev(binary, 28, 31);
+	int state = bitsGet(binary, 27);
+	int all = bitsGet(binary, 26);
+	int id = bitsToDecRev(binary, 0, 25);
 
 	createMessage(id, unit, state, all, dimlevel, 0);
 }
@@ -141,13 +135,13 @@ static void createStart(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBin(id, binary);
+	length = decToBits(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=((length-i)+1)*4;
 			createHigh(106-x, 106-(x-3));
 		}
@@ -172,13 +166,13 @@ static void createState(int state) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBin(unit, binary);
+	length = decToBits(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=((length-i)+1)*4;
 			createHigh(130-x, 130-(x-3));
 		}
@@ -186,13 +180,13 @@ static void createUnit(int unit) {
 }
 
 static void createDimlevel(int dimlevel) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBin(dimlevel, binary);
+	length = decToBits(dimlevel, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=((length-i)+1)*4;
 			createHigh(146-x, 146-(x-3));
 		}
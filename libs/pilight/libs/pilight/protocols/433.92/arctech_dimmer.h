@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *arctech_dimmer;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *arctech_dimmer;
 void arctechDimmerInit(void);
 
 #endif
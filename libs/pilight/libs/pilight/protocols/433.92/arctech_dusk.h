@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *arctech_dusk;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *arctech_dusk;
 void arctechDuskInit(void);
 
 #endif
@@ -25,7 +25,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "arctech_motion.h"
 
@@ -64,25 +64,19 @@ static void createMessage(int id, int unit, int state, int all) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(arctech_motion->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "arctech_motion: parsecode - invalid parameter passed %d", arctech_motion->rawlen);
 		return;
 	}
 
-	for(x=0;x<arctech_motion->rawlen;x+=4) {
-		if(arctech_motion->raw[x+3] > AVG_PULSE_LENGTH*PULSE_MULTIPLIER) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&arctech_motion->raw[3], (arctech_motion->rawlen+3)/4, 4, AVG_PULSE_LENGTH*PULSE_MULTIPLIER, binary);
 
-	int unit = binToDecRev(binary, 28, 31);
-	int state = binary[27];
-	int all = binary[26];
-	int id = binToDecRev(binary, 0, 25);
+	int unit = bitsToDecRev(binary, 28, 31);
+	int state = bitsGet(binary, 27);
+	int all = bitsGet(binary, 26);
+	int id = bitsToDecRev(binary, 0, 25);
 
 	createMessage(id, unit, state, all);
 }
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *arctech_motion;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *arctech_motion;
 void arctechMotionInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "arctech_screen.h"
 
@@ -73,25 +73,19 @@ static void createMessage(int id, int unit, int state, int all, int learn) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(arctech_screen->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "arctech_screen: parsecode - invalid parameter passed %d", arctech_screen->rawlen);
 		return;
 	}
 
-	for(x=0;x<arctech_screen->rawlen;x+=4) {
-		if(arctech_screen->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&arctech_screen->raw[3], (arctech_screen->rawlen+3)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int unit = binToDecRev(binary, 28, 31);
-	int state = binary[27];
-	int all = binary[26];
-	int id = binToDecRev(binary, 0, 25);
+	int unit = bitsToDecRev(binary, 28, 31);
+	int state = bitsGet(binary, 27);
+	int all = bitsGet(binary, 26);
+	int id = bitsToDecRev(binary, 0, 25);
 
 	createMessage(id, unit, state, all, 0);
 }
@@ -128,13 +122,13 @@ static void createStart(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBin(id, binary);
+	length = decToBits(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=((length-i)+1)*4;
 			createHigh(106-x, 106-(x-3));
 		}
@@ -154,13 +148,13 @@ static void createState(int state) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBin(unit, binary);
+	length = decToBits(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=((length-i)+1)*4;
 			createHigh(130-x, 130-(x-3));
 		}
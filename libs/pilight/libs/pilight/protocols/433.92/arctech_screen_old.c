@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "arctech_screen_old.h"
 
@@ -58,7 +58,7 @@ static void createMessage(int id, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 	int len = (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2));
 
 	if(arctech_screen_old->rawlen>RAW_LENGTH) {
@@ -66,17 +66,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<arctech_screen_old->rawlen-2;x+=4) {
-		if(arctech_screen_old->raw[x+3] > len) {
-			binary[i++] = 0;
-		} else {
-			binary[i++] = 1;
-		}
-	}
+	pulsesToBits(&arctech_screen_old->raw[3], (arctech_screen_old->rawlen+1)/4, 4, len, binary);
+	bitsInvert(binary, (arctech_screen_old->rawlen+1)/4);
 
-	int unit = binToDec(binary, 0, 3);
-	int state = binary[11];
-	int id = binToDec(binary, 4, 8);
+	int unit = bitsToDec(binary, 0, 3);
+	int state = bitsGet(binary, 11);
+	int id = bitsToDec(binary, 4, 8);
 	createMessage(id, unit, state);
 }
 
@@ -108,13 +103,13 @@ static void clearCode(void) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createLow(x, x+3);
 		}
@@ -122,13 +117,13 @@ static void createUnit(int unit) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createLow(16+x, 16+x+3);
 		}
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *arctech_screen_old;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *arctech_screen_old;
 void arctechScreenOldInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "arctech_switch_old.h"
 
@@ -58,7 +58,10 @@ static void createMessage(int id, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)], low[BITS_WORDS(RAW_LENGTH/4)];
+	uint64_t high[BITS_WORDS(RAW_LENGTH/4)], last[BITS_WORDS(RAW_LENGTH/4)];
+	uint64_t valid[BITS_WORDS(RAW_LENGTH/4)] = { 0 };
+	int x = 0;
 	int len = (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2));
 
 	if(arctech_switch_old->rawlen>RAW_LENGTH) {
@@ -66,36 +69,22 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<arctech_switch_old->rawlen-3;x+=4) {
-		// valid telegrams must consist of 0110 and 1001 blocks
-		int low_high = 0;
-		if(arctech_switch_old->raw[x] > len) {
-			low_high |= 1;
-		}
-		if(arctech_switch_old->raw[x+1] > len) {
-			low_high |= 2;
-		}
-		if(arctech_switch_old->raw[x+2] > len) {
-			low_high |= 4;
-		}
-		if(arctech_switch_old->raw[x+3] > len) {
-			low_high |= 8;
-		}
-		switch(low_high) {
-			case 6:
-				binary[i++] = 1;
-			break;
-			case 10:
-				binary[i++] = 0;
-			break;
-			default:
-				return; // invalid telegram
+	pulsesToBits(&arctech_switch_old->raw[0], arctech_switch_old->rawlen/4, 4, len, low);
+	pulsesToBits(&arctech_switch_old->raw[1], arctech_switch_old->rawlen/4, 4, len, high);
+	pulsesToBits(&arctech_switch_old->raw[2], arctech_switch_old->rawlen/4, 4, len, binary);
+	pulsesToBits(&arctech_switch_old->raw[3], arctech_switch_old->rawlen/4, 4, len, last);
+
+	// valid telegrams must consist of 0110 and 1001 blocks
+	bitsInvert(valid, arctech_switch_old->rawlen/4);
+	for(x=0;x<BITS_WORDS(RAW_LENGTH/4);x++) {
+		if((~low[x] & high[x] & (binary[x] ^ last[x]) & valid[x]) != valid[x]) {
+			return; // invalid telegram
 		}
 	}
 
-	int unit = binToDec(binary, 0, 3);
-	int state = binary[11];
-	int id = binToDec(binary, 4, 8);
+	int unit = bitsToDec(binary, 0, 3);
+	int state = bitsGet(binary, 11);
+	int id = bitsToDec(binary, 4, 8);
 	createMessage(id, unit, state);
 }
 
@@ -127,13 +116,13 @@ static void clearCode(void) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createLow(x, x+3);
 		}
@@ -141,13 +130,13 @@ static void createUnit(int unit) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createLow(16+x, 16+x+3);
 		}
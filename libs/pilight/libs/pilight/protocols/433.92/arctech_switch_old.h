@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *arctech_switch_old;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *arctech_switch_old;
 void arctechSwitchOldInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "auriol.h"
 
@@ -42,7 +42,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(auriol->rawlen == RAW_LENGTH) {
@@ -56,7 +56,7 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int channel = 0, id = 0, battery = 0;
 	double temp_offset = 0.0, temperature = 0.0;
 
@@ -65,19 +65,13 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<auriol->rawlen-2;x+=2) {
-		if(auriol->raw[x] > AVG_PULSE_LENGTH*PULSE_MULTIPLIER) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&auriol->raw[1], (auriol->rawlen-2)/2, 2, AVG_PULSE_LENGTH*PULSE_MULTIPLIER, binary);
 
-	id = binToDecRev(binary, 0, 7);
-	battery = binary[8];
-	channel = 1 + binToDecRev(binary, 10, 11); // channel as id
-	temperature = (double)binToSignedRev(binary, 12, 23)/10;
-	// checksum = (double)binToDecRev(binary, 24, 31); been unable to deciper it
+	id = bitsToDecRev(binary, 0, 7);
+	battery = bitsGet(binary, 8);
+	channel = 1 + bitsToDecRev(binary, 10, 11); // channel as id
+	temperature = (double)bitsToSignedRev(binary, 12, 23)/10;
+	// checksum = (double)bitsToDecRev(binary, 24, 31); been unable to deciper it
 	struct settings_t *tmp = settings;
 	while(tmp) {
 		if(fabs(tmp->id-id) < EPSILON) {
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *auriol;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *auriol;
 void auriolInit(void);
 
 #endif
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *beamish_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *beamish_switch;
 void beamishSwitchInit(void);
 
 #endif
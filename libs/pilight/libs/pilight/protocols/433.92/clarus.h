@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *clarus_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *clarus_switch;
 void clarusSwitchInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "cleverwatts.h"
 
@@ -62,7 +62,7 @@ static void createMessage(int id, int unit, int state, int all) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = 0, state = 0, unit = 0, all = 0;
 
 	if(cleverwatts->rawlen>RAW_LENGTH) {
@@ -70,18 +70,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<cleverwatts->rawlen-1;x+=2) {
-		if(cleverwatts->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&cleverwatts->raw[1], (cleverwatts->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	id = binToDecRev(binary, 0, 19);
-	state = binary[20];
-	unit = binToDecRev(binary, 21, 22);
-	all = binary[23];
+	id = bitsToDecRev(binary, 0, 19);
+	state = bitsGet(binary, 20);
+	unit = bitsToDecRev(binary, 21, 22);
+	all = bitsGet(binary, 23);
 
 	createMessage(id, unit, state, all);
 }
@@ -109,13 +103,13 @@ static void clearCode(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(39-(x+1), 39-x);
 		}
@@ -135,13 +129,13 @@ static void createState(int state) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(45-(x+1), 45-x);
 		}
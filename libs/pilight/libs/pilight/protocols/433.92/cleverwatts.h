@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *cleverwatts;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *cleverwatts;
 void cleverwattsInit(void);
 
 #endif
@@ -25,7 +25,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "conrad_rsl_contact.h"
 
@@ -57,7 +57,7 @@ static void createMessage(int id, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 
 	if(conrad_rsl_contact->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "conrad_rsl_contact: parsecode - invalid parameter passed %d", conrad_rsl_contact->rawlen);
@@ -65,18 +65,12 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=0; x<conrad_rsl_contact->rawlen; x+=2) {
-		if(conrad_rsl_contact->raw[x+1] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/2]=1;
-		} else {
-			binary[x/2]=0;
-		}
-	}
+	pulsesToBits(&conrad_rsl_contact->raw[1], (conrad_rsl_contact->rawlen+1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int id = binToDecRev(binary, 6, 31);
-	int check = binToDecRev(binary, 0, 3);
-	int check1 = binary[32];
-	int state = binary[4];
+	int id = bitsToDecRev(binary, 6, 31);
+	int check = bitsToDecRev(binary, 0, 3);
+	int check1 = bitsGet(binary, 32);
+	int state = bitsGet(binary, 4);
 
 	if(check == 5 && check1 == 1) {
 		createMessage(id, state);
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *conrad_rsl_contact;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *conrad_rsl_contact;
 void conradRSLContactInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "conrad_rsl_switch.h"
 
@@ -38,7 +38,7 @@
 #define AVG_PULSE_LENGTH	200
 #define RAW_LENGTH				66
 
-static int codes[5][4][2];
+static PROTOCOL_THREAD_LOCAL int codes[5][4][2];
 
 static int validate(void) {
 	if(conrad_rsl_switch->rawlen == RAW_LENGTH) {
@@ -73,7 +73,7 @@ static void createMessage(int id, int unit, int state, int learn) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = 0, unit = 0, state = 0;
 
 	if(conrad_rsl_switch->rawlen>RAW_LENGTH) {
@@ -82,15 +82,10 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=0;x<conrad_rsl_switch->rawlen;x+=2) {
-		if(conrad_rsl_switch->raw[x+1] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/2]=0;
-		} else {
-			binary[x/2]=1;
-		}
-	}
+	pulsesToBits(&conrad_rsl_switch->raw[1], (conrad_rsl_switch->rawlen+1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
+	bitsInvert(binary, (conrad_rsl_switch->rawlen+1)/2);
 
-	int check = binToDecRev(binary, 0, 7);
+	int check = bitsToDecRev(binary, 0, 7);
 	int match = 0;
 	for(id=0;id<5;id++) {
 		for(unit=0;unit<4;unit++) {
@@ -139,13 +134,13 @@ static void clearCode(void) {
 		// createHigh(x,x+1);
 	// }
 
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 
-	length = decToBinRev(23876, binary);
+	length = decToBitsRev(23876, binary);
 	for(i=0;i<=length;i++) {
 		x=i*2;
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			createLow(x+16, x+16+1);
 		} else {
 			createHigh(x+16, x+16+1);
@@ -154,16 +149,16 @@ static void clearCode(void) {
 }
 
 static void createId(int id, int unit, int state) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
 	int code = codes[id][unit][state];
 
-	length = decToBin(code, binary);
+	length = decToBits(code, binary);
 	for(i=0;i<=length;i++) {
 		x=i*2;
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			createLow(x, x+1);
 		} else {
 			createHigh(x, x+1);
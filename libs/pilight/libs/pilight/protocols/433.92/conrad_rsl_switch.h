@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *conrad_rsl_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *conrad_rsl_switch;
 void conradRSLSwitchInit(void);
 
 #endif
@@ -25,7 +25,7 @@
 #include "../../core/common.h"
 #include "../../core/dso.h"
 #include "../../core/log.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "../protocol.h"
 #include "daycom.h"
@@ -60,7 +60,7 @@ static void createMessage(int id, int systemcode, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = -1, state = -1, unit = -1, systemcode = -1;
 
 	if(daycom->rawlen>RAW_LENGTH) {
@@ -68,18 +68,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<daycom->rawlen;x+=2) {
-		if(daycom->raw[x] > AVG_PULSE_LENGTH*(PULSE_MULTIPLIER/2)) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&daycom->raw[0], (daycom->rawlen+1)/2, 2, AVG_PULSE_LENGTH*(PULSE_MULTIPLIER/2), binary);
 
-	id = binToDecRev(binary, 0, 5);
-	systemcode = binToDecRev(binary, 6, 19);
-	unit = binToDecRev(binary, 21, 23 );
-	state = binary[20];
+	id = bitsToDecRev(binary, 0, 5);
+	systemcode = bitsToDecRev(binary, 6, 19);
+	unit = bitsToDecRev(binary, 21, 23 );
+	state = bitsGet(binary, 20);
 	createMessage(id, systemcode, unit, state);
 }
 
@@ -103,13 +97,13 @@ static void clearCode(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(11-(x+1), 11-x);
 		}
@@ -118,13 +112,13 @@ static void createId(int id) {
 
 
 static void createSystemCode(int systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(systemcode, binary);
+	length = decToBitsRev(systemcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(39-(x+1), 39-x);
 		}
@@ -132,13 +126,13 @@ static void createSystemCode(int systemcode) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(47-(x+1), 47-x);
 		}
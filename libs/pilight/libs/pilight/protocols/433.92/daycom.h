@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *daycom;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *daycom;
 void daycomInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "ehome.h"
 
@@ -58,23 +58,17 @@ static void createMessage(int id, int state) {
 }
 
 static void parseCode(void) {
-	int i = 0, binary[RAW_LENGTH/4];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(ehome->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "ehome: parsecode - invalid parameter passed %d", ehome->rawlen);
 		return;
 	}
 
-	for(i=0;i<ehome->rawlen-2;i+=4) {
-		if(ehome->raw[i+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i/4]=1;
-		} else {
-			binary[i/4]=0;
-		}
-	}
+	pulsesToBits(&ehome->raw[3], (ehome->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int id = binToDec(binary, 1, 3);
-	int state = binary[0];
+	int id = bitsToDec(binary, 1, 3);
+	int state = bitsGet(binary, 0);
 
 	createMessage(id, state);
 }
@@ -117,13 +111,13 @@ static void clearCode(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(4+x, 4+(x+3));
 		}
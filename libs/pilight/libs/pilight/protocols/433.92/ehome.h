@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *ehome;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *ehome;
 void ehomeInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "elro_300_switch.h"
 
@@ -80,7 +80,8 @@ static void createMessage(unsigned long long systemcode, int unitcode, int state
  *
  */
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)], even[BITS_WORDS(RAW_LENGTH/2)];
+	int x = 0;
 
 	if(elro_300_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "elro_300_switch: parsecode - invalid parameter passed %d", elro_300_switch->rawlen);
@@ -91,24 +92,20 @@ static void parseCode(void) {
 	//at this point the code field holds translated "0" and "1" codes from the received pulses
 	//this means that we have to combine these ourselves into meaningful values in groups of 2
 
-	for(i=0; i < elro_300_switch->rawlen; i++) {
-		if(elro_300_switch->raw[i] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			if(i&1) {
-				binary[x++] = 1;
-			} else {
-				return; // even pulse lengths must be low
-			}
-		} else if(i&1) {
-			binary[x++] = 0;
+	pulsesToBits(&elro_300_switch->raw[0], (elro_300_switch->rawlen+1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), even);
+	for(x=0; x<BITS_WORDS(RAW_LENGTH/2); x++) {
+		if(even[x] != 0) {
+			return; // even pulse lengths must be low
 		}
 	}
+	pulsesToBits(&elro_300_switch->raw[1], elro_300_switch->rawlen/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
 	//chunked code now contains "groups of 2" codes for us to handle.
-	unsigned long long systemcode = binToDecRevUl(binary, 11, 42);
-	int groupcode = binToDec(binary, 43, 46);
-	int groupcode2 = binToDec(binary, 49, 50);
-	int unitcode = binToDec(binary, 51, 56);
-	int state = binToDec(binary, 47, 48);
+	unsigned long long systemcode = bitsToDecRev(binary, 11, 42);
+	int groupcode = bitsToDec(binary, 43, 46);
+	int groupcode2 = bitsToDec(binary, 49, 50);
+	int unitcode = bitsToDec(binary, 51, 56);
+	int state = bitsToDec(binary, 47, 48);
 	int groupRes = 0;
 
 	if(groupcode == 13 && groupcode2 == 2) {
@@ -169,12 +166,12 @@ static void elro300ClearCode(void) {
  * systemcode : unsigned integer number, the 32 bit system code
  */
 static void createSystemCode(unsigned long long systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
-	length = decToBinRevUl(systemcode, binary);
+	length = decToBitsRevUl(systemcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[(length)-i]==1) {
+		if(bitsGet(binary, (length)-i)==1) {
 			x=i*2;
 			createHigh(22+x, 22+x+1);
 		}
@@ -187,13 +184,13 @@ static void createSystemCode(unsigned long long systemcode) {
  * unitcode : integer number, id of the unit to control
  */
 static void createUnitCode(int unitcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unitcode, binary);
+	length = decToBitsRev(unitcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createHigh(102+x, 102+x+1);
 		}
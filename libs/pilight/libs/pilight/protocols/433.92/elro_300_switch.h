@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *elro_300_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *elro_300_switch;
 void elro300SwitchInit(void);
 
 #endif
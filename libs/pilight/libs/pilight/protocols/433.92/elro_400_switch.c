@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "elro_400_switch.h"
 
@@ -59,24 +59,19 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, i = 0, binary[RAW_LENGTH/4];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(elro_400_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "elro_400_switch: parsecode - invalid parameter passed %d", elro_400_switch->rawlen);
 		return;
 	}
 
-	for(x=0;x<elro_400_switch->rawlen-2;x+=4) {
-		if(elro_400_switch->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 0;
-		} else {
-			binary[i++] = 1;
-		}
-	}
+	pulsesToBits(&elro_400_switch->raw[3], (elro_400_switch->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
+	bitsInvert(binary, (elro_400_switch->rawlen+1)/4);
 
-	int systemcode = binToDecRev(binary, 0, 4);
-	int unitcode = binToDecRev(binary, 5, 9);
-	int state = binary[11];
+	int systemcode = bitsToDecRev(binary, 0, 4);
+	int unitcode = bitsToDecRev(binary, 5, 9);
+	int state = bitsGet(binary, 11);
 	createMessage(systemcode, unitcode, state);
 }
 
@@ -106,13 +101,13 @@ static void clearCode(void) {
 }
 
 static void createSystemCode(int systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(systemcode, binary);
+	length = decToBitsRev(systemcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createLow(19-(x+3), 19-x);
 		}
@@ -120,13 +115,13 @@ static void createSystemCode(int systemcode) {
 }
 
 static void createUnitCode(int unitcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unitcode, binary);
+	length = decToBitsRev(unitcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createLow(39-(x+3), 39-x);
 		}
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *elro_400_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *elro_400_switch;
 void elro400SwitchInit(void);
 
 #endif
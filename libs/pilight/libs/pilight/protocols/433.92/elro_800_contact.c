@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "elro_800_contact.h"
 
@@ -59,24 +59,18 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(elro_800_contact->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "elro_800_contact: parsecode - invalid parameter passed %d", elro_800_contact->rawlen);
 		return;
 	}
 
-	for(x=0;x<elro_800_contact->rawlen-2;x+=4) {
-		if(elro_800_contact->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&elro_800_contact->raw[3], (elro_800_contact->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int systemcode = binToDec(binary, 0, 4);
-	int unitcode = binToDec(binary, 5, 9);
-	int state = binary[11];
+	int systemcode = bitsToDec(binary, 0, 4);
+	int unitcode = bitsToDec(binary, 5, 9);
+	int state = bitsGet(binary, 11);
 	createMessage(systemcode, unitcode, state);
 }
 
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *elro_800_contact;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *elro_800_contact;
 void elro800ContactInit(void);
 
 #endif
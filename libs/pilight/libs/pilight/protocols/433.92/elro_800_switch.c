@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "elro_800_switch.h"
 
@@ -59,35 +59,23 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/4], x = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(elro_800_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "elro_800_switch: parsecode - invalid parameter passed %d", elro_800_switch->rawlen);
 		return;
 	}
 
-	for(x=0;x<elro_800_switch->rawlen-2;x+=4) {
-		if(elro_800_switch->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4] = 1;
-		} else {
-			binary[x/4] = 0;
-		}
-	}
+	pulsesToBits(&elro_800_switch->raw[3], (elro_800_switch->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int systemcode = binToDec(binary, 0, 4);
-	int unitcode = binToDec(binary, 5, 9);
-	int check = binary[10];
-	int state = binary[11];
+	int systemcode = bitsToDec(binary, 0, 4);
+	int unitcode = bitsToDec(binary, 5, 9);
+	int check = bitsGet(binary, 10);
+	int state = bitsGet(binary, 11);
 
 	// second part of systemcode based on Med
-	for(x=0;x<=16;x+=4) {
-		if(elro_800_switch->raw[x+0] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4] = 1;
-		} else {
-			binary[x/4] = 0;
-		}
-	}
-	int systemcode2 = binToDec(binary, 0, 4);
+	pulsesToBits(&elro_800_switch->raw[0], 5, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
+	int systemcode2 = bitsToDec(binary, 0, 4);
 
 	systemcode |= (systemcode2<<5);
 
@@ -133,21 +121,21 @@ static void clearCode(void) {
 }
 
 static void createSystemCode(int systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(systemcode & 0x1F, binary);
+	length = decToBitsRev(systemcode & 0x1F, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(x, x+3);
 		}
 	}
 
-	length = decToBinRev((systemcode>>5) & 0x1F, binary);
+	length = decToBitsRev((systemcode>>5) & 0x1F, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createMed(x, x+3);
 		}
@@ -155,13 +143,13 @@ static void createSystemCode(int systemcode) {
 }
 
 static void createUnitCode(int unitcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unitcode, binary);
+	length = decToBitsRev(unitcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(20+x, 20+x+3);
 		}
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *elro_800_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *elro_800_switch;
 void elro800SwitchInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "eurodomest_switch.h"
 
@@ -96,19 +96,20 @@ static void createMessage(int id, int unit, int state, int all, int learn) {
 }
 
 static void parseCode(void) {
-	int binary[BINARY_LENGTH], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(BINARY_LENGTH)] = { 0 };
+	int x = 0, i = 0;
 
 	for (x = 0; x < eurodomest_switch->rawlen - 2; x += 2) {
 		if ((eurodomest_switch->raw[x] >= MIN_MEDIUM_PULSE_LENGTH) &&
 		    (eurodomest_switch->raw[x] <= MAX_MEDIUM_PULSE_LENGTH) &&
 		    (eurodomest_switch->raw[x + 1] >= MIN_SHORT_PULSE_LENGTH) &&
 		    (eurodomest_switch->raw[x + 1] <= MAX_SHORT_PULSE_LENGTH)) {
-			binary[i++] = 0;
+			bitsSet(binary, i++, 0);
 		} else if ((eurodomest_switch->raw[x] >= MIN_SHORT_PULSE_LENGTH) &&
 			   (eurodomest_switch->raw[x] <= MAX_SHORT_PULSE_LENGTH) &&
 			   (eurodomest_switch->raw[x + 1] >= MIN_MEDIUM_PULSE_LENGTH) &&
 			   (eurodomest_switch->raw[x + 1] <= MAX_MEDIUM_PULSE_LENGTH)) {
-			binary[i++] = 1;
+			bitsSet(binary, i++, 1);
 		} else {
 			return; // decoding failed, return without creating message
 		}
@@ -120,43 +121,43 @@ static void parseCode(void) {
 	int all = 0;
 	int state = 0;
 
-	if (binary[20] == 0 && binary[21] == 0 && binary[22] == 0 && binary[23] == 0) {
+	if (bitsGet(binary, 20) == 0 && bitsGet(binary, 21) == 0 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 0) {
 	  	unit = 1;
 	  	all = 0;
 	  	state = 1; // on
-	} else if (binary[20] == 0 && binary[21] == 0 && binary[22] == 0 && binary[23] == 1) {
+	} else if (bitsGet(binary, 20) == 0 && bitsGet(binary, 21) == 0 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 1) {
 	  	unit = 1;
 	  	all = 0;
 	  	state = 0; // off
-	} else if (binary[20] == 0 && binary[21] == 0 && binary[22] == 1 && binary[23] == 1) {
+	} else if (bitsGet(binary, 20) == 0 && bitsGet(binary, 21) == 0 && bitsGet(binary, 22) == 1 && bitsGet(binary, 23) == 1) {
 	  	unit = 2;
 	  	all = 0;
 	  	state = 0; // off
-	} else if (binary[20] == 0 && binary[21] == 0 && binary[22] == 1 && binary[23] == 0) {
+	} else if (bitsGet(binary, 20) == 0 && bitsGet(binary, 21) == 0 && bitsGet(binary, 22) == 1 && bitsGet(binary, 23) == 0) {
 	  	unit = 2;
 	  	all = 0;
 	  	state = 1; // on
-	} else if (binary[20] == 0 && binary[21] == 1 && binary[22] == 0 && binary[23] == 1) {
+	} else if (bitsGet(binary, 20) == 0 && bitsGet(binary, 21) == 1 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 1) {
 	  	unit = 3;
 	  	all = 0;
 	  	state = 0; // off
-	} else if (binary[20] == 0 && binary[21] == 1 && binary[22] == 0 && binary[23] == 0) {
+	} else if (bitsGet(binary, 20) == 0 && bitsGet(binary, 21) == 1 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 0) {
 	  	unit = 3;
 	  	all = 0;
 	  	state = 1; // on
-	} else if (binary[20] == 1 && binary[21] == 0 && binary[22] == 0 && binary[23] == 1) {
+	} else if (bitsGet(binary, 20) == 1 && bitsGet(binary, 21) == 0 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 1) {
 	  	unit = 4;
 	  	all = 0;
 	  	state = 0; // off
-	} else if (binary[20] == 1 && binary[21] == 0 && binary[22] == 0 && binary[23] == 0) {
+	} else if (bitsGet(binary, 20) == 1 && bitsGet(binary, 21) == 0 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 0) {
 	  	unit = 4;
 	  	all = 0;
 	  	state = 1; // on
-	} else if (binary[20] == 1 && binary[21] == 1 && binary[22] == 1 && binary[23] == 0) {
+	} else if (bitsGet(binary, 20) == 1 && bitsGet(binary, 21) == 1 && bitsGet(binary, 22) == 1 && bitsGet(binary, 23) == 0) {
 	  	unit = 0; // not used, all = 1
 	  	all = 1;
 	  	state = 0; // off
-	} else if (binary[20] == 1 && binary[21] == 1 && binary[22] == 0 && binary[23] == 1) {
+	} else if (bitsGet(binary, 20) == 1 && bitsGet(binary, 21) == 1 && bitsGet(binary, 22) == 0 && bitsGet(binary, 23) == 1) {
 	  	unit = 0; // not used, all = 1
 	  	all = 1;
 	  	state = 1; // on
@@ -164,7 +165,7 @@ static void parseCode(void) {
 		return; // decoding failed, return without creating message
 	}
 
-	int id = binToDec(binary, 0, 19);
+	int id = (int)bitsToDec(binary, 0, 19);
 	createMessage(id, unit, state, all, 0);
 }
 
@@ -187,16 +188,16 @@ static void createHigh(int s, int e) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i = 0, x = 0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for (i = 0; i <= length; i++) {
-		if (binary[i] == 0) {
+		if (bitsGet(binary, i) == 0) {
 			x = i * 2;
 			createLow(x, x+1);
-		} else { //so binary[i] == 1
+		} else { //so bitsGet(binary, i) == 1
 			x = i * 2;
 			createHigh(x, x + 1);
 		}
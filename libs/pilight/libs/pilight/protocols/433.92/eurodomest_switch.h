@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *eurodomest_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *eurodomest_switch;
 void eurodomestSwitchInit(void);
 
 #endif
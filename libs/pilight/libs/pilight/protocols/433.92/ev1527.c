@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "ev1527.h"
 
@@ -58,23 +58,17 @@ static void createMessage(int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 
 	if(ev1527->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "ev1527: parsecode - invalid parameter passed %d", ev1527->rawlen);
 		return;
 	}
 
-	for(x=0;x<ev1527->rawlen-2;x+=2) {
-		if(ev1527->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&ev1527->raw[3], (ev1527->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int unitcode = binToDec(binary, 0, 19);
-	int state = binary[20];
+	int unitcode = bitsToDec(binary, 0, 19);
+	int state = bitsGet(binary, 20);
 	createMessage(unitcode, state);
 }
 
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *ev1527;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *ev1527;
 void ev1527Init(void);
 
 #endif
@@ -49,7 +49,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "fanju.h"
 
@@ -69,7 +69,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(fanju->rawlen == RAW_LENGTH) {
@@ -83,8 +83,10 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i=0, x=0, binary[MSG_LENGTH];
-	int binary_cpy[MSG_LENGTH], mask=0, checksum_calc=0, bit=0;
+	uint64_t binary[BITS_WORDS(MSG_LENGTH)];
+	uint64_t binary_cpy[BITS_WORDS(36)] = { 0 };
+	int i=0;
+	int mask=0, checksum_calc=0, bit=0;
 	int header=0, id=0, channel=0, battery=0, checksum=0;
 	double temp_offset=0.0, temperature=0.0, temp_fahrenheit=0.0, temp_celsius=0.0;
 	double humi_offset=0.0, humidity=0.0;
@@ -95,44 +97,30 @@ static void parseCode(void) {
 		return;
 	}
 
-	x = 0;
-	for(i=1; i < fanju->rawlen - 2; i+=2) {
-		if(fanju->raw[i] > AVG_PULSE) {
-			binary[x++] = 1;
-		} else {
-			binary[x++] = 0;
-		}
-	}
+	pulsesToBits(&fanju->raw[1], (fanju->rawlen-2)/2, 2, AVG_PULSE, binary);
 
 	// 4x SYNC '0' + 1x HEAD '1'
-	header = binToDecRev(binary, 0, 4);
+	header = bitsToDecRev(binary, 0, 4);
 	if(header != 1) {
 		logprintf(LOG_ERR, "fanju: parsecode - invalid header %d", header);
 		return;
 	}
 
-	id = binToDecRev(binary, OFFSET, OFFSET + 7);
-	checksum = binToDecRev(binary, OFFSET + 8, OFFSET + 11);
-	battery = binary[13];
-	temp_fahrenheit = (double) binToDecRevUl(binary, OFFSET + 16, OFFSET + 27);
+	id = bitsToDecRev(binary, OFFSET, OFFSET + 7);
+	checksum = bitsToDecRev(binary, OFFSET + 8, OFFSET + 11);
+	battery = bitsGet(binary, 13);
+	temp_fahrenheit = (double) bitsToDecRev(binary, OFFSET + 16, OFFSET + 27);
 	temp_celsius = ((temp_fahrenheit - 0x4C4) * 5) / 9;
 	temperature = temp_celsius / 10;
-	humidity_10 = binToDecRev(binary, OFFSET + 28, OFFSET + 31);
-	humidity = (double) binToDecRev(binary, OFFSET + 32, OFFSET + 35);
+	humidity_10 = bitsToDecRev(binary, OFFSET + 28, OFFSET + 31);
+	humidity = (double) bitsToDecRev(binary, OFFSET + 32, OFFSET + 35);
 	humidity += humidity_10 * 10;
-	channel = binToDecRev(binary, OFFSET + 38, OFFSET + 39);
+	channel = bitsToDecRev(binary, OFFSET + 38, OFFSET + 39);
 
 	// move channel to the checksum position
-	x = 0;
-	for(i=OFFSET + 0; i < OFFSET + 8; i++) {
-		binary_cpy[x++] = binary[i];
-	}
-	for(i=OFFSET + 36; i < OFFSET + 40; i++) {
-		binary_cpy[x++] = binary[i];
-	}
-	for(i=OFFSET + 12; i < OFFSET + 36; i++) {
-		binary_cpy[x++] = binary[i];
-	}
+	bitsFromDecRev(binary_cpy, 0, 7, bitsToDecRev(binary, OFFSET + 0, OFFSET + 7));
+	bitsFromDecRev(binary_cpy, 8, 11, bitsToDecRev(binary, OFFSET + 36, OFFSET + 39));
+	bitsFromDecRev(binary_cpy, 12, 35, bitsToDecRev(binary, OFFSET + 12, OFFSET + 35));
 	// verify checksum
 	mask = 0xC;
 	checksum_calc = 0x0;
@@ -142,7 +130,7 @@ static void parseCode(void) {
 		if(bit == 0x1) {
 			mask ^= 0x9;
 		}
-		if(binary_cpy[i] == 1) {
+		if(bitsGet(binary_cpy, i) == 1) {
 			checksum_calc ^= mask;
 		}
 	}
@@ -12,7 +12,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *fanju;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *fanju;
 void fanjuInit(void);
 
 #endif
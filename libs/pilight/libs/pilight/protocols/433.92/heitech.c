@@ -26,7 +26,7 @@
 #include "../../core/common.h"
 #include "../../core/dso.h"
 #include "../../core/log.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "../protocol.h"
 #include "heitech.h"
@@ -61,25 +61,19 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/4];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(heitech->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "heitech: parsecode - invalid parameter passed %d", heitech->rawlen);
 		return;
 	}
 
-	for(x=0;x<heitech->rawlen-2;x+=4) {
-		if(heitech->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4]=1;
-		} else {
-			binary[x/4]=0;
-		}
-	}
+	pulsesToBits(&heitech->raw[3], (heitech->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int systemcode = binToDec(binary, 0, 4);
-	int unitcode = binToDec(binary, 5, 9);
-	int check = binary[10];
-	int state = binary[11];
+	int systemcode = bitsToDec(binary, 0, 4);
+	int unitcode = bitsToDec(binary, 5, 9);
+	int check = bitsGet(binary, 10);
+	int state = bitsGet(binary, 11);
 
 	if(check != state) {
 		createMessage(systemcode, unitcode, state);
@@ -113,13 +107,13 @@ static void clearCode(void) {
 }
 
 static void createSystemCode(int systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(systemcode, binary);
+	length = decToBitsRev(systemcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(x, x+3);
 		}
@@ -127,13 +121,13 @@ static void createSystemCode(int systemcode) {
 }
 
 static void createUnitCode(int unitcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unitcode, binary);
+	length = decToBitsRev(unitcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(20+x, 20+x+3);
 		}
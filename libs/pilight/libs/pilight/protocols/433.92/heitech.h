@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *heitech;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *heitech;
 void heitechInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "impuls.h"
 
@@ -59,7 +59,8 @@ static void createMessage(int systemcode, int programcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, binary[RAW_LENGTH/4];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)], first[BITS_WORDS(RAW_LENGTH/4)];
+	int x = 0;
 
 	if(impuls->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "impuls: parsecode - invalid parameter passed %d", impuls->rawlen);
@@ -67,19 +68,16 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=0;x<impuls->rawlen-2;x+=4) {
-		if(impuls->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)) ||
-		   impuls->raw[x+0] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4]=1;
-		} else {
-			binary[x/4]=0;
-		}
+	pulsesToBits(&impuls->raw[3], (impuls->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
+	pulsesToBits(&impuls->raw[0], (impuls->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), first);
+	for(x=0;x<BITS_WORDS(RAW_LENGTH/4);x++) {
+		binary[x] |= first[x];
 	}
 
-	int systemcode = binToDec(binary, 0, 4);
-	int programcode = binToDec(binary, 5, 9);
-	int check = binary[10];
-	int state = binary[11];
+	int systemcode = bitsToDec(binary, 0, 4);
+	int programcode = bitsToDec(binary, 5, 9);
+	int check = bitsGet(binary, 10);
+	int state = bitsGet(binary, 11);
 
 	if(check != state) {
 		createMessage(systemcode, programcode, state);
@@ -124,13 +122,13 @@ static void clearCode(void) {
 }
 
 static void createSystemCode(int systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(systemcode, binary);
+	length = decToBitsRev(systemcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createMed(x, x+3);
 		}
@@ -138,13 +136,13 @@ static void createSystemCode(int systemcode) {
 }
 
 static void createProgramCode(int programcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(programcode, binary);
+	length = decToBitsRev(programcode, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(20+x, 20+x+3);
 		}
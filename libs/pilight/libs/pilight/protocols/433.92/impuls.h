@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *impuls;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *impuls;
 void impulsInit(void);
 
 #endif
@@ -15,7 +15,7 @@
 #include "../../core/common.h"
 #include "../../core/dso.h"
 #include "../../core/log.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "../protocol.h"
 #include "iwds07.h"
@@ -57,7 +57,7 @@ static void createMessage(int unit, int alert, int state, int fault) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], i=0, x=0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int unit=0, alert=-1, state=-1, fault=-1;
 
 	if(iwds07->rawlen>RAW_LENGTH) {
@@ -65,18 +65,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<iwds07->rawlen-2;x+=2) {
-		if(iwds07->raw[x] < AVG_PULSE_LENGTH) {
-			binary[i++]=0;
-		} else {
-			binary[i++]=1;
-		}
-	}
+	pulsesToBits(&iwds07->raw[0], (iwds07->rawlen-1)/2, 2, AVG_PULSE_LENGTH-1, binary);
 
-	unit = binToDec(binary, 0, 19);
-	alert = binToDec(binary, 20, 20);
-	state = binToDec(binary, 21, 21);
-	fault = binToDec(binary, 23, 23);
+	unit = bitsToDec(binary, 0, 19);
+	alert = bitsToDec(binary, 20, 20);
+	state = bitsToDec(binary, 21, 21);
+	fault = bitsToDec(binary, 23, 23);
 	createMessage(unit, alert, state, fault);
 }
 
@@ -11,7 +11,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *iwds07;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *iwds07;
 void iwds07Init(void);
 
 #endif
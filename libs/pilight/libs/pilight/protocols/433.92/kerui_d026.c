@@ -16,7 +16,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "kerui_d026.h"
 
 
@@ -57,21 +57,15 @@ static void createMessage(int unitcode, int state, int state2, int state3, int s
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, i = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 
-	for(x=0;x<kerui_D026->rawlen-2;x+=2) {
-		if(kerui_D026->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&kerui_D026->raw[0], (kerui_D026->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int unitcode = binToDec(binary, 0, 19);
-	int state = binary[20];
-	int state2 = binary[21];
-	int state3 = binary[22];
-	int state4 = binary[23];
+	int unitcode = bitsToDec(binary, 0, 19);
+	int state = bitsGet(binary, 20);
+	int state2 = bitsGet(binary, 21);
+	int state3 = bitsGet(binary, 22);
+	int state4 = bitsGet(binary, 23);
 	createMessage(unitcode, state, state2, state3, state4);
 }
 
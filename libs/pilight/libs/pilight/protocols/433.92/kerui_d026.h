@@ -11,7 +11,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *kerui_D026;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *kerui_D026;
 void keruiD026Init(void);
 
 #endif
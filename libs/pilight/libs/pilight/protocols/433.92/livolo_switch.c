@@ -18,7 +18,7 @@
 
 #include "livolo_switch.h"
 
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/log.h"
 
 #if defined(MODULE) && !defined(_WIN32)
@@ -58,17 +58,17 @@ static int createHigh(int i) {
 }
 
 static int createBits(int value, int start, int length) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int l = 0;
 	int i = 0, x = start;
 
-	l = decToBin(value, binary);
+	l = decToBits(value, binary);
 	// Pad with zeroes
 	for(i=0;i<length-1-l;i++) {
 		x += createLow(x);
 	};
 	for(i=0;i<=l;i++) {
-		if(binary[i] == 1) {
+		if(bitsGet(binary, i) == 1) {
 			x += createHigh(x);
 		} else {
 			x += createLow(x);
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *livolo_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *livolo_switch;
 void livoloSwitchInit(void);
 
 #endif
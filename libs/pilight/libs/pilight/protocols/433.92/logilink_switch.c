@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "logilink_switch.h"
 
@@ -59,7 +59,7 @@ static void createMessage(int systemcode, int unitcode, int state) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int systemcode = 0, state = 0, unitcode = 0;
 
 	if(logilink_switch->rawlen>RAW_LENGTH) {
@@ -67,16 +67,10 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<logilink_switch->rawlen-1;x+=2) {
-		if(logilink_switch->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
-	systemcode = binToDecRev(binary, 0, 19);
-	state = binary[20];
-	unitcode = binToDecRev(binary, 21, 23);
+	pulsesToBits(&logilink_switch->raw[0], logilink_switch->rawlen/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
+	systemcode = bitsToDecRev(binary, 0, 19);
+	state = bitsGet(binary, 20);
+	unitcode = bitsToDecRev(binary, 21, 23);
 
 	createMessage(systemcode, unitcode, state);
 }
@@ -104,13 +98,13 @@ static void clearCode(void) {
 }
 
 static void createSystemCode(int systemcode) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length=0;
 	int i = 0, x = 38;
 
-	length = decToBin(systemcode, binary);
+	length = decToBits(systemcode, binary);
 	for(i=length;i>=0;i--) {
-		if(binary[i] == 1) {
+		if(bitsGet(binary, i) == 1) {
 			createHigh(x, x+1);
 		}
 
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *logilink_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *logilink_switch;
 void logilinkSwitchInit(void);
 
 #endif
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *mumbi;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *mumbi;
 void mumbiInit(void);
 
 #endif
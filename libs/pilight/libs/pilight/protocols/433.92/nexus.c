@@ -31,7 +31,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/common.h"
 #include "../../core/dso.h"
 #include "../../core/gc.h"
@@ -62,7 +62,7 @@ typedef struct settings_t {
     struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 /**
  * Validate whether a raw pulse length matches a known type
@@ -82,7 +82,7 @@ static int validate(void) {
 static void parseCode(void) {
     int id = 0, battery = 0, channel = 0;
     double temperature = 0.0, humidity = 0.0;
-    int binary[MAXBITS];
+    uint64_t binary[BITS_WORDS(MAXBITS)] = { 0 };
     int x = 0, i = 0;
 
     // decode pulses into bits, we only parse the needed amount and ignore everything after
@@ -91,9 +91,9 @@ static void parseCode(void) {
             return;
         }
         if(isValidPulse(nexus->raw[x], ONE_P)) {
-            binary[i++] = 1;
+            bitsSet(binary, i++, 1);
         } else if(isValidPulse(nexus->raw[x], ZERO_P)) {
-            binary[i++] = 0;
+            bitsSet(binary, i++, 0);
         } else {
             // invalid pulse length
             return;
@@ -101,19 +101,19 @@ static void parseCode(void) {
     }
 
     // bit 10 should be 0 and bits 25-28 should be 1
-    if(binary[9] != 0) {
+    if(bitsGet(binary, 9) != 0) {
         return;
     }
-    if(binary[24] != 1 || binary[25] != 1 || binary[26] != 1 || binary[27] != 1) {
+    if(bitsToDecRev(binary, 24, 27) != 0xF) {
         return;
     }
 
     // decode bits into data
-    id = binToDecRev(binary, 0, 7);
-    battery = binary[8] ? 1 : 0;
-    channel = binToDecRev(binary, 10, 11);
-    temperature = (double)binToSignedRev(binary, 12, 23);
-    humidity = (double)binToDecRev(binary, 28, 35);
+    id = (int)bitsToDecRev(binary, 0, 7);
+    battery = bitsGet(binary, 8) ? 1 : 0;
+    channel = (int)bitsToDecRev(binary, 10, 11);
+    temperature = (double)bitsToSignedRev(binary, 12, 23);
+    humidity = (double)bitsToDecRev(binary, 28, 35);
 
     temperature /= 10;
     double temperature_decimals = 1;
@@ -11,7 +11,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *nexus;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *nexus;
 void nexusInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "ninjablocks_weather.h"
 
@@ -52,7 +52,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(ninjablocks_weather->rawlen >= MIN_RAW_LENGTH && ninjablocks_weather->rawlen <= MAX_RAW_LENGTH) {
@@ -74,7 +74,8 @@ static void createMessage(int id, int unit, double temperature, double humidity)
 }
 
 static void parseCode(void) {
-	int x = 0, pRaw = 0, binary[MAX_RAW_LENGTH/2];
+	int x = 0, pRaw = 0;
+	uint64_t binary[BITS_WORDS(MAX_RAW_LENGTH/2+1)] = { 0 };
 	int iParity = 1, iParityData = -1;	// init for even parity
 	int iHeaderSync = 12;				// 1100
 	int iDataSync = 6;					// 110
@@ -90,12 +91,10 @@ static void parseCode(void) {
 	for(x=0; x<=(MAX_RAW_LENGTH/2); x++) {
 		if(ninjablocks_weather->raw[pRaw] > PULSE_NINJA_WEATHER_LOWER &&
 		  ninjablocks_weather->raw[pRaw] < PULSE_NINJA_WEATHER_UPPER) {
-			binary[x] = 1;
+			bitsSet(binary, x, 1);
 			iParityData = iParity;
 			iParity = -iParity;
 			pRaw++;
-		} else {
-			binary[x] = 0;
 		}
 		pRaw++;
 	}
@@ -104,12 +103,12 @@ static void parseCode(void) {
 	}
 
 	// Binary record: 0-3 sync0, 4-7 unit, 8-9 id, 10-12 sync1, 13-19 humidity, 20-34 temperature, 35 even par, 36 footer
-	int headerSync = binToDecRev(binary, 0,3);
-	int unit = binToDecRev(binary, 4,7);
-	int id = binToDecRev(binary, 8,9);
-	int dataSync = binToDecRev(binary, 10,12);
-	double humidity = binToDecRev(binary, 13,19);	// %
-	double temperature = binToDecRev(binary, 20,34);
+	int headerSync = (int)bitsToDecRev(binary, 0,3);
+	int unit = (int)bitsToDecRev(binary, 4,7);
+	int id = (int)bitsToDecRev(binary, 8,9);
+	int dataSync = (int)bitsToDecRev(binary, 10,12);
+	double humidity = bitsToDecRev(binary, 13,19);	// %
+	double temperature = bitsToDecRev(binary, 20,34);
 	// ((temp * (100 / 128)) - 5000) * 10 °C, 2 digits
 	temperature = ((int)((double)(temperature * 0.78125)) - 5000);
 
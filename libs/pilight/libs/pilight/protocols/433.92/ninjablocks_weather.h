@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *ninjablocks_weather;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *ninjablocks_weather;
 void ninjablocksWeatherInit(void);
 
 #endif
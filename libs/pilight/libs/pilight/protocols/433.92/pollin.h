@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *pollin;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *pollin;
 void pollinInit(void);
 
 #endif
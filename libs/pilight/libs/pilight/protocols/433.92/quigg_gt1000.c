@@ -56,7 +56,6 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
 #include "../../core/gc.h"
 #include "quigg_gt1000.h"
 
@@ -197,7 +196,7 @@ int supercodes[2*NRSUPERCODES] = {
 	/* ON codes */
 	0x0F005,0x1F008,0x4F015,0x5F018,0x8F025,0x9F028,0xCF02C,0xDF03C };
 
-static char bincode[BIN_LENGTH+1];
+static PROTOCOL_THREAD_LOCAL char bincode[BIN_LENGTH+1];
 
 static void createMessage(int id, int unit, int state, int seq, int learn) {
 	int i = 0;
@@ -397,6 +396,7 @@ void quiggGT1000Init(void) {
 	quigg_gt1000->devtype = SWITCH;
 	quigg_gt1000->hwtype = RF433;
 	quigg_gt1000->txrpt = NORMAL_REPEATS;
+	quigg_gt1000->randomopt = "num";
 	quigg_gt1000->minrawlen = RAW_LENGTH;
 	quigg_gt1000->maxrawlen = RAW_LENGTH;
 	quigg_gt1000->maxgaplen = (int)PROG_SPACE*1.1;
@@ -25,7 +25,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *quigg_gt1000;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *quigg_gt1000;
 void quiggGT1000Init(void);
 
 #endif
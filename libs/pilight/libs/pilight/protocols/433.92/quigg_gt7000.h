@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *quigg_gt7000;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *quigg_gt7000;
 void quiggGT7000Init(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "quigg_gt9000.h"
 
@@ -122,13 +122,13 @@ static int validate(void) {
 	return -1;
 }
 
-static void createMessage(int *binary, int systemcode, int state, int unit) {
+static void createMessage(const uint64_t *binary, int systemcode, int state, int unit) {
 	int i = 0;
 	char binaryCh[RAW_LENGTH/2];
 	quigg_gt9000->message = json_mkobject();
 	if(binary != NULL) {
         	for(i=0;i<RAW_LENGTH/2;i++) {
-                	if(binary[i] == 0) {
+                	if(bitsGet(binary, i) == 0) {
                 		binaryCh[i] = '0';
                 	} else {
                 		binaryCh[i] = '1';
@@ -157,42 +157,37 @@ static int decodePayload(int payload, int index, int syscodetype) {
 	return ret;
 }
 
-static int parseSystemcode(int *binary) {
-	int systemcode1dec = binToDecRev(binary, 0, 3);
-	int systemcode2enc = binToDecRev(binary, 4, 7);
+static int parseSystemcode(const uint64_t *binary) {
+	int systemcode1dec = (int)bitsToDecRev(binary, 0, 3);
+	int systemcode2enc = (int)bitsToDecRev(binary, 4, 7);
 	int systemcode2dec = 0; //calculate all codes with base syscode2 = 0
-	int systemcode3enc = binToDecRev(binary, 8, 11);
+	int systemcode3enc = (int)bitsToDecRev(binary, 8, 11);
 	int systemcode3dec = decodePayload(systemcode3enc, systemcode2enc, systemcode1dec);
-	int systemcode4enc = binToDecRev(binary, 12, 15);
+	int systemcode4enc = (int)bitsToDecRev(binary, 12, 15);
 	int systemcode4dec = decodePayload(systemcode4enc, systemcode3enc, systemcode1dec);
-	int systemcode5enc = binToDecRev(binary, 16, 19);
+	int systemcode5enc = (int)bitsToDecRev(binary, 16, 19);
 	int systemcode5dec = decodePayload(systemcode5enc, systemcode4enc, systemcode1dec);
 	int systemcode = (systemcode1dec<<16) + (systemcode2dec<<12) + (systemcode3dec<<8) + (systemcode4dec<<4) + systemcode5dec;
 
 	return systemcode;
 }
 
-static void pulseToBinary(int *binary) {
-	int x = 0;
-	for(x=0; x<quigg_gt9000->rawlen-1; x+=2) {
-		if(quigg_gt9000->raw[x+1] > AVG_PULSE_LENGTH) {
-  			binary[x/2] = 0;
-		} else {
-  			binary[x/2] = 1;
-		}
-	}
+static void pulseToBinary(uint64_t *binary) {
+	pulsesToBits(&quigg_gt9000->raw[1], quigg_gt9000->rawlen/2, 2, AVG_PULSE_LENGTH, binary);
+	bitsInvert(binary, quigg_gt9000->rawlen/2);
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], state = 0;
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
+	int state = 0;
   	int i = 0;
 
 	pulseToBinary(binary);
 
-  	int syscodetype = binToDecRev(binary, 0, 3);
+  	int syscodetype = (int)bitsToDecRev(binary, 0, 3);
 	int systemcode = parseSystemcode(binary);
-	int statecode = binToDecRev(binary, 16, 19);
-	int unit = binToDec(binary, 20, 23);
+	int statecode = (int)bitsToDecRev(binary, 16, 19);
+	int unit = (int)bitsToDec(binary, 20, 23);
 
 	//validate unit & statecode
 	if(isSyscodeType1(syscodetype)) {
@@ -238,24 +233,26 @@ static void clearCode(void) {
 }
 
 static void createEncryptedData(int encrypteddata) {
-	int binary[20], length = 0, i = 0, x = 0;
+	uint64_t binary[BITS_WORDS(64)];
+	int length = 0, i = 0, x = 0;
 
-	length = decToBin(encrypteddata, binary);
+	length = decToBits(encrypteddata, binary);
 	for(i=0;i<=length;i++) {
 		x = (i+19-length)*2;
-		if(binary[i] == 1) {
+		if(bitsGet(binary, i) == 1) {
 			createOne(x, x+1);
 		}
 	}
 }
 
 static void createUnit(int unit) {
-	int binary[4], length = 0, i = 0, x = 20;
+	uint64_t binary[BITS_WORDS(64)];
+	int length = 0, i = 0, x = 20;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
 		x = i*2 + 20*2;
-		if(binary[i] == 1) {
+		if(bitsGet(binary, i) == 1) {
 			createOne(x, x+1);
 		}
 	}
@@ -297,7 +294,8 @@ static int createCode(JsonNode *code) {
 	int syscodetype = 0;
 	double itmp = -1;
 	int unit = -1, systemcode = -1, verifysyscode = -1, state = -1, all = 0, statecode = -1;
-	int allcodes[16], binary[RAW_LENGTH/2];
+	int allcodes[16];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 
 	if(json_find_number(code, "id", &itmp) == 0)
 		systemcode = (int)round(itmp);
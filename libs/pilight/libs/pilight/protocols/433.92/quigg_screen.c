@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "quigg_screen.h"
 
@@ -78,8 +78,9 @@ static void createMessage(int id, int state, int unit, int all, int learn) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2], x = 0, dec_unit[4] = {0, 3, 1, 2};
-	int iParity = 1, iParityData = -1;	// init for even parity
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
+	int x = 0, dec_unit[4] = {0, 3, 1, 2};
+	int iParityData = 0;
 	int iSwitch = 0;
 
 	if(quigg_screen->rawlen>RAW_LENGTH) {
@@ -89,26 +90,19 @@ static void parseCode(void) {
 
 	// 42 bytes are the number of raw bytes
 	// Byte 1,2 in raw buffer is the first logical byte, rawlen-3,-2 is the parity bit, rawlen-1 is the footer
-	for(x=0; x<quigg_screen->rawlen-1; x+=2) {
-		if(quigg_screen->raw[x+1] > PULSE_QUIGG_SCREEN_50) {
-			binary[x/2] = 1;
-			if((x / 2) > 11 && (x / 2) < 19) {
-				iParityData = iParity;
-				iParity = -iParity;
-			}
-		} else {
-			binary[x/2] = 0;
-		}
+	pulsesToBits(&quigg_screen->raw[1], quigg_screen->rawlen/2, 2, PULSE_QUIGG_SCREEN_50, binary);
+
+	// even parity of data bits 12..18
+	for(x=bitsToDecRev(binary, 12, 18); x != 0; x >>= 1) {
+		iParityData ^= x & 1;
 	}
-	if(iParityData < 0)
-		iParityData=0;
-
-	int id = binToDecRev(binary, 0, 11);
-	int unit = binToDecRev(binary, 12, 13);
-	int all = binToDecRev(binary, 14, 14);
-	int state = binToDecRev(binary, 15, 15);
-	int screen = binToDecRev(binary, 16, 16);
-	int parity = binToDecRev(binary, 19, 19);
+
+	int id = bitsToDecRev(binary, 0, 11);
+	int unit = bitsToDecRev(binary, 12, 13);
+	int all = bitsToDecRev(binary, 14, 14);
+	int state = bitsToDecRev(binary, 15, 15);
+	int screen = bitsToDecRev(binary, 16, 16);
+	int parity = bitsToDecRev(binary, 19, 19);
 	int learn = 0;
 
 	unit = dec_unit[unit];
@@ -161,11 +155,12 @@ static void clearCode(void) {
 }
 
 static void createId(int id) {
-	int binary[16], length = 0, i = 0, x = 23;
+	uint64_t binary[BITS_WORDS(64)];
+	int length = 0, i = 0, x = 23;
 
-	length = decToBin(id, binary);
+	length = decToBits(id, binary);
 	for(i=length;i>=0;i--) {
-		if(binary[i] == 1) {
+		if(bitsGet(binary, i) == 1) {
 			createOne(x, x+1);
 		}
 		x = x-2;
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *quigg_screen;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *quigg_screen;
 void quiggScreenInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "rc101.h"
 
@@ -63,24 +63,18 @@ static void createMessage(int id, int state, int unit, int all) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 
 	if(rc101->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "rc101: parsecode - invalid parameter passed %d", rc101->rawlen);
 		return;
 	}
 
-	for(i=0;i<rc101->rawlen; i+=2) {
-		if(rc101->raw[i] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x++] = 1;
-		} else {
-			binary[x++] = 0;
-		}
-	}
+	pulsesToBits(&rc101->raw[0], (rc101->rawlen+1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int id = binToDec(binary, 0, 19);
-	int state = binary[20];
-	int unit = 7-binToDec(binary, 21, 23);
+	int id = bitsToDec(binary, 0, 19);
+	int state = bitsGet(binary, 20);
+	int unit = 7-bitsToDec(binary, 21, 23);
 	int all = 0;
 	if(unit == 7 && state == 1) {
 		all = 1;
@@ -116,13 +110,13 @@ static void clearCode(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createHigh(x, x+1);
 		}
@@ -130,13 +124,13 @@ static void createId(int id) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(7-unit, binary);
+	length = decToBitsRev(7-unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createHigh(42+x, 42+x+1);
 		}
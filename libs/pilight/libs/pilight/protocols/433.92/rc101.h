@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *rc101;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *rc101;
 void rc101Init(void);
 
 #endif
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *rev1_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *rev1_switch;
 void rev1Init(void);
 
 #endif
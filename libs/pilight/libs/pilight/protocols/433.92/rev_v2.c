@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "rev_v2.h"
 
@@ -58,35 +58,37 @@ static void createMessage(char *id, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, z = 65, binary[RAW_LENGTH/4];
-	char id[3];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)], floating[BITS_WORDS(RAW_LENGTH/4)];
+	int x = 0, z = 65;
+	char id[4];
 
 	if(rev2_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "rev2_switch: parsecode - invalid parameter passed %d", rev2_switch->rawlen);
 		return;
 	}
 
-	/* Convert the one's and zero's into binary */
-	for(x=0;x<rev2_switch->rawlen-2;x+=4) {
-		if(rev2_switch->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4]=1;
-		} else if(rev2_switch->raw[x+0] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[x/4]=2;
-		} else {
-			binary[x/4]=0;
-		}
+	/* Convert the one's and zero's into binary, a long first pulse is a floating bit (2) */
+	pulsesToBits(&rev2_switch->raw[3], (rev2_switch->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
+	pulsesToBits(&rev2_switch->raw[0], (rev2_switch->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), floating);
+	for(x=0;x<BITS_WORDS(RAW_LENGTH/4);x++) {
+		floating[x] &= ~binary[x];
 	}
 
 	for(x=9;x>=5;--x) {
-		if(binary[x] == 2) {
+		if(bitsGet(floating, x)) {
 			break;
 		}
 		z++;
 	}
 
-	int unit = binToDecRev(binary, 0, 5);
-	int state = binary[11];
-	int y = binToDecRev(binary, 6, 9);
+	// floating bits are non-zero values too
+	for(x=0;x<BITS_WORDS(RAW_LENGTH/4);x++) {
+		binary[x] |= floating[x];
+	}
+
+	int unit = bitsToDecRev(binary, 0, 5);
+	int state = bitsGet(floating, 11) ? 2 : bitsGet(binary, 11);
+	int y = bitsToDecRev(binary, 6, 9);
 	sprintf(&id[0], "%c%d", z, y);
 
 	createMessage(id, unit, state);
@@ -131,13 +133,13 @@ static void clearCode(void) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(23-(x+3), 23-x);
 		}
@@ -147,14 +149,14 @@ static void createUnit(int unit) {
 static void createId(char *id) {
 	int l = ((int)(id[0]))-65;
 	int y = atoi(&id[1]);
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(y, binary);
+	length = decToBitsRev(y, binary);
 	for(i=0;i<=length;i++) {
 		x=i*4;
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			createHigh(39-(x+3), 39-x);
 		}
 	}
@@ -178,7 +180,7 @@ static void createFooter(void) {
 }
 
 static int createCode(struct JsonNode *code) {
-	char id[3] = {'\0'};
+	char id[4] = {'\0'};
 	int unit = -1;
 	int state = -1;
 	double itmp = -1;
@@ -186,8 +188,13 @@ static int createCode(struct JsonNode *code) {
 
 	strcpy(id, "-1");
 
-	if(json_find_string(code, "id", &stmp) == 0)
-		strcpy(id, stmp);
+	if(json_find_string(code, "id", &stmp) == 0) {
+		if(strlen(stmp) >= sizeof(id)) {
+			logprintf(LOG_ERR, "rev2_switch: invalid id range");
+			return EXIT_FAILURE;
+		}
+		strncpy(id, stmp, sizeof(id)-1);
+	}
 
 	if(json_find_number(code, "off", &itmp) == 0)
 		state=0;
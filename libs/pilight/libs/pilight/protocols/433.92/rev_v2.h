@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *rev2_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *rev2_switch;
 void rev2Init(void);
 
 #endif
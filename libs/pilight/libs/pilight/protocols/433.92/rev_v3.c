@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "rev_v3.h"
 
@@ -59,7 +59,7 @@ static void createMessage(int id, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, i = 0, binary[RAW_LENGTH/4];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
 
 	if(rev3_switch->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "rev3_switch: parsecode - invalid parameter passed %d", rev3_switch->rawlen);
@@ -67,17 +67,11 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=0;x<rev3_switch->rawlen-2;x+=4) {
-		if(rev3_switch->raw[x+3] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&rev3_switch->raw[3], (rev3_switch->rawlen+1)/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	int unit = binToDec(binary, 6, 9);
-	int state = binary[11];
-	int id = binToDec(binary, 0, 5);
+	int unit = bitsToDec(binary, 6, 9);
+	int state = bitsGet(binary, 11);
+	int id = bitsToDec(binary, 0, 5);
 
 	createMessage(id, unit, state);
 }
@@ -109,13 +103,13 @@ static void clearCode(void) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*4;
 			createHigh(24+x, 24+x+3);
 		}
@@ -123,14 +117,14 @@ static void createUnit(int unit) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
 		x=i*4;
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			createHigh(x, x+3);
 		}
 	}
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *rev3_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *rev3_switch;
 void rev3Init(void);
 
 #endif
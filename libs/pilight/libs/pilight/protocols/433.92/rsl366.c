@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "rsl366.h"
 
@@ -62,7 +62,8 @@ static void createMessage(int systemcode, int programcode, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, i = 0, binary[RAW_LENGTH/4];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/4)];
+	int i = 0;
 
 	if(rsl366->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "rsl366: parsecode - invalid parameter passed %d", rsl366->rawlen);
@@ -70,33 +71,27 @@ static void parseCode(void) {
 	}
 
 	/* Convert the one's and zero's into binary */
-	for(x=3;x<rsl366->rawlen;x+=4) {
-		if(rsl366->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++]=1;
-		} else {
-			binary[i++]=0;
-		}
-	}
+	pulsesToBits(&rsl366->raw[3], rsl366->rawlen/4, 4, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
 	//Check if there is a valid systemcode
-	if((binary[0]+binary[1]+binary[2]+binary[3]) > 1)
+	if((bitsGet(binary, 0)+bitsGet(binary, 1)+bitsGet(binary, 2)+bitsGet(binary, 3)) > 1)
                 return;
 
         //Get systemcode: 1000=>1, 0100=>2, 0010=>3, 0001=>4
         int systemcode = 0;
         for(i=0;i<4;i++) {
-        	if(binary[i] == 1)
+        	if(bitsGet(binary, i) == 1)
         		systemcode = i+1;
         }
 
         //Check if there is a valid programcode
-        if((binary[4]+binary[5]+binary[6]+binary[7]) > 1)
+        if((bitsGet(binary, 4)+bitsGet(binary, 5)+bitsGet(binary, 6)+bitsGet(binary, 7)) > 1)
                 return;
 
         //Get programcode: 1000=>1, 0100=>2, 0010=>3, 0001=>4
         int programcode = 0;
         for(i=4;i<8;i++) {
-        	if(binary[i] == 1)
+        	if(bitsGet(binary, i) == 1)
         		programcode = i-3;
         }
 
@@ -105,7 +100,7 @@ static void parseCode(void) {
         	return;
 
 	// There seems to be no check and binary[10] is always a low
-	int state = binary[11]^1;
+	int state = bitsGet(binary, 11)^1;
 
 	createMessage(systemcode, programcode, state);
 }
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *rsl366;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *rsl366;
 void rsl366Init(void);
 
 #endif
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *sc2262;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *sc2262;
 void sc2262Init(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "secudo_smoke.h"
 
@@ -48,9 +48,8 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = 0;
-	int x = 0, i = 0;
 
 	int len = (AVG_PULSE_LENGTH*(PULSE_MULTIPLIER+1)) / 2;
 
@@ -59,15 +58,9 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<secudo_smoke->rawlen-2;x+=2) {
-		if(secudo_smoke->raw[x] > len) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&secudo_smoke->raw[1], (secudo_smoke->rawlen-2)/2, 2, len, binary);
 
-	id = binToDec(binary, 0, 9);
+	id = bitsToDec(binary, 0, 9);
 	id = (~id) & 1023;
 
 	secudo_smoke->message = json_mkobject();
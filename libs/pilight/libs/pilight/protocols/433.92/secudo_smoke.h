@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *secudo_smoke;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *secudo_smoke;
 void secudoSmokeInit(void);
 
 #endif
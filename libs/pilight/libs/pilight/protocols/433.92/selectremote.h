@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *selectremote;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *selectremote;
 void selectremoteInit(void);
 
 #endif
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *silvercrest;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *silvercrest;
 void silvercrestInit(void);
 
 #endif
@@ -11,7 +11,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *smartwares_switch;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *smartwares_switch;
 void smartwaresSwitchInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "tcm.h"
 
@@ -53,7 +53,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(tcm->rawlen == RAW_LENGTH) {
@@ -69,30 +69,23 @@ static int validate(void) {
 static void parseCode(void) {
 	double humi_offset = 0.0, temp_offset = 0.0;
 	double temperature = 0.0, humidity = 0.0;
-	int binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = 0, button = 0, battery = 0;
-	int i = 0, x = 0;
 
 	if(tcm->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "tcm: parsecode - invalid parameter passed %d", tcm->rawlen);
 		return;
 	}
 
-	for(x=1;x<tcm->rawlen-2;x+=2) {
-		if(tcm->raw[x] > AVG_PULSE_LENGTH*PULSE_MULTIPLIER) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&tcm->raw[1], (tcm->rawlen-2)/2, 2, AVG_PULSE_LENGTH*PULSE_MULTIPLIER, binary);
 
-	id = binToDecRev(binary, 0, 7);
-	battery = !binary[8];
-	button = binary[11];
+	id = bitsToDecRev(binary, 0, 7);
+	battery = !bitsGet(binary, 8);
+	button = bitsGet(binary, 11);
 
-	humidity = binToDecRev(binary, 16, 23);
+	humidity = bitsToDecRev(binary, 16, 23);
 
-	temperature = binToSignedRev(binary, 24, 35);
+	temperature = bitsToSignedRev(binary, 24, 35);
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *tcm;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *tcm;
 void tcmInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "techlico_switch.h"
 
@@ -63,7 +63,8 @@ static void createMessage(int id, int unit, int state) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, y = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
+	int y = 0;
 	int id = -1, state = -1, unit = -1, code = 0;
 
 	if(techlico_switch->rawlen>RAW_LENGTH) {
@@ -71,16 +72,10 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=0;x<techlico_switch->rawlen;x+=2) {
-		if(techlico_switch->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&techlico_switch->raw[0], (techlico_switch->rawlen+1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	id = binToDecRev(binary, 0, 15);
-	code = binToDecRev(binary, 16, 23);
+	id = bitsToDecRev(binary, 0, 15);
+	code = bitsToDecRev(binary, 16, 23);
 
 	for(y=0;y<NRMAP;y++) {
 		if(map[y] == code) {
@@ -117,13 +112,13 @@ static void clearCode(void) {
 }
 
 static void createId(int id) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(id, binary);
+	length = decToBitsRev(id, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(31-(x+1), 31-x);
 		}
@@ -131,13 +126,13 @@ static void createId(int id) {
 }
 
 static void createUnit(int unit) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0;
 
-	length = decToBinRev(unit, binary);
+	length = decToBitsRev(unit, binary);
 	for(i=0;i<=length;i++) {
-		if(binary[i]==1) {
+		if(bitsGet(binary, i)==1) {
 			x=i*2;
 			createLow(47-(x+1), 47-x);
 		}
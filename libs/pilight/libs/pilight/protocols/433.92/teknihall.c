@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "teknihall.h"
 
@@ -43,7 +43,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(teknihall->rawlen == RAW_LENGTH) {
@@ -57,7 +57,7 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int id = 0, battery = 0;
 	double temperature = 0.0, humidity = 0.0;
 	double humi_offset = 0.0, temp_offset = 0.0;
@@ -67,18 +67,12 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=1;x<teknihall->rawlen-1;x+=2) {
-		if(teknihall->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&teknihall->raw[1], (teknihall->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
-	id = binToDecRev(binary, 0, 7);
-	battery = binary[8];
-	temperature = binToSignedRev(binary, 13, 23);
-	humidity = binToDecRev(binary, 24, 30);
+	id = bitsToDecRev(binary, 0, 7);
+	battery = bitsGet(binary, 8);
+	temperature = bitsToSignedRev(binary, 13, 23);
+	humidity = bitsToDecRev(binary, 24, 30);
 
 	struct settings_t *tmp = settings;
 	while(tmp) {
@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *teknihall;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *teknihall;
 void teknihallInit(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "tfa.h"
 
@@ -47,7 +47,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(tfa->rawlen == MIN_RAW_LENGTH || tfa->rawlen == MED_RAW_LENGTH || tfa->rawlen == MAX_RAW_LENGTH) {
@@ -60,12 +60,12 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 	int temp1 = 0, temp2 = 0, temp3 = 0;
 	int humi1 = 0, humi2 = 0;
 	int id = 0, battery = 0, crc = 0;
 	int channel = 0;
-	int i = 0, x = 0, xLoop = 1;
+	int i = 0, xLoop = 1;
 	double humi_offset = 0.0, temp_offset = 0.0;
 	double temperature = 0.0, humidity = 0.0;
 
@@ -82,42 +82,36 @@ static void parseCode(void) {
 		return;
 	}
 
-	for(x=xLoop;x<tfa->rawlen-2;x+=2) {
-		if(tfa->raw[x] > AVG_PULSE_LENGTH*PULSE_MULTIPLIER) {
-			binary[i++] = 1;
-		} else {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&tfa->raw[xLoop], (tfa->rawlen-1-xLoop)/2, 2, AVG_PULSE_LENGTH*PULSE_MULTIPLIER, binary);
 
 	if(tfa->rawlen == MED_RAW_LENGTH || tfa->rawlen == MAX_RAW_LENGTH) {
 		for(i=0;i<34;i++) {
-			if(binary[i] != (crc&1)) {
+			if(bitsGet(binary, i) != (crc&1)) {
 				crc = (crc>>1) ^ 12;
 			} else {
 				crc = (crc>>1);
 			}
 		}
-		crc ^= binToDec(binary, 34, 37);
-		if (crc != binToDec(binary, 38, 41)) {
+		crc ^= bitsToDec(binary, 34, 37);
+		if (crc != bitsToDec(binary, 38, 41)) {
 			return; // incorrect checksum
 		}
 
-		id = binToDecRev(binary, 2, 9);
-		channel = binToDecRev(binary, 12, 13) + 1;
+		id = bitsToDecRev(binary, 2, 9);
+		channel = bitsToDecRev(binary, 12, 13) + 1;
 
-		temp1 = binToDecRev(binary, 14, 17);
-		temp2 = binToDecRev(binary, 18, 21);
-		temp3 = binToDecRev(binary, 22, 25);
+		temp1 = bitsToDecRev(binary, 14, 17);
+		temp2 = bitsToDecRev(binary, 18, 21);
+		temp3 = bitsToDecRev(binary, 22, 25);
 
 		// Convert from °F to °C,  a zero value is equivalent to -90.00 °F with an exp of 10, we enlarge that to 2 digit
 		temperature = (double)(((((temp1 + temp2*16 + temp3*256) * 10) - 9000 - 3200) * 5) / 9);
 
-		humi1 = binToDecRev(binary, 26, 29);
-		humi2 = binToDecRev(binary, 30, 33);
+		humi1 = bitsToDecRev(binary, 26, 29);
+		humi2 = bitsToDecRev(binary, 30, 33);
 		humidity = (double)(humi1 + humi2*16);
 
-		if(binToDecRev(binary, 35, 35) == 1) {
+		if(bitsToDecRev(binary, 35, 35) == 1) {
 			battery = 0;
 		} else {
 			battery = 1;
@@ -127,19 +121,19 @@ static void parseCode(void) {
 
 	// must be MIN_RAW_LENGTH, we can omit it here, as validate has checked that condition already
 	// SOENS has binary 1001 in the first 4 bits, if not we discard further processing of the protocol
-		id = binToDecRev(binary, 0, 3);
+		id = bitsToDecRev(binary, 0, 3);
 		if(id == 9) {
 
-			id = binToDecRev(binary, 4, 11);		// 12 - 0, 13 - Tx Button
-			channel = binToDecRev(binary, 14, 15) + 1;
+			id = bitsToDecRev(binary, 4, 11);		// 12 - 0, 13 - Tx Button
+			channel = bitsToDecRev(binary, 14, 15) + 1;
 
-			temp1 = binToSignedRev(binary, 16, 27);
+			temp1 = bitsToSignedRev(binary, 16, 27);
 			temperature = (double)(temp1*10);
 
-			humi1 = binToDecRev(binary, 28, 35);
+			humi1 = bitsToDecRev(binary, 28, 35);
 			humidity = (double)humi1;
 
-			if(binToDecRev(binary, 36, 36) == 1) {
+			if(bitsToDecRev(binary, 36, 36) == 1) {
 				battery = 0;
 			} else {
 				battery = 1;
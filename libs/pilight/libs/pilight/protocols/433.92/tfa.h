@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *tfa;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *tfa;
 void tfaInit(void);
 
 #endif
@@ -16,7 +16,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "tfa2017.h"
 
 #define MIN_PULSE_LENGTH	250
@@ -32,7 +32,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(tfa2017->rawlen >= MIN_RAW_LENGTH && tfa2017->rawlen <= MAX_RAW_LENGTH) {
@@ -43,10 +43,15 @@ static int validate(void) {
 	return -1;
 }
 
+// Message of MESSAGE_LENGTH bits starting at bit start
+static unsigned long long message(const uint64_t *binary, int start) {
+	return bitsToDecRev(binary, start, start+MESSAGE_LENGTH-1);
+}
+
 static void parseCode(void) {
 	int i = 0, x = 0, short_pulse = 0, prev = 0, long_pulse = 0;
-	int s = 0, start[3], m = 0, binary[MAX_RAW_LENGTH];
-	int msg[MESSAGE_LENGTH], channel = 0;
+	int s = 0, start[3], m = 0, channel = 0;
+	uint64_t binary[BITS_WORDS(MAX_RAW_LENGTH)], msg[BITS_WORDS(MESSAGE_LENGTH)] = { 0 };
 	double humidity = 0.0, temperature = 0.0;
 
 	if(tfa2017->rawlen > MAX_RAW_LENGTH) {
@@ -55,7 +60,7 @@ static void parseCode(void) {
 	}
 	for(x=0;x<tfa2017->rawlen;x++) {
 		if(tfa2017->raw[x] > AVG_PULSE) {
-			binary[i++] = 0;
+			bitsSet(binary, i++, 0);
 			if(short_pulse > 0) {
 				prev = short_pulse;
 				short_pulse = 0;
@@ -64,7 +69,7 @@ static void parseCode(void) {
 		} else {
 			short_pulse++;
 			if(short_pulse % 2 == 0) {
-				binary[i++] = 1;
+				bitsSet(binary, i++, 1);
 			}
 			long_pulse = 0;
 		}
@@ -81,11 +86,11 @@ static void parseCode(void) {
 		return;
 	}
 
-	if(i > (start[1] + MESSAGE_LENGTH) && memcmp(&binary[start[0]], &binary[start[1]], MESSAGE_LENGTH) == 0) {
+	if(i > (start[1] + MESSAGE_LENGTH) && message(binary, start[0]) == message(binary, start[1])) {
 		m=start[0];
 	} else if(s > 2 && i > (start[2] + MESSAGE_LENGTH)) {
-		if(memcmp(&binary[start[0]], &binary[start[2]], MESSAGE_LENGTH) == 0 ||
-			 memcmp(&binary[start[1]], &binary[start[2]], MESSAGE_LENGTH) == 0) {
+		if(message(binary, start[0]) == message(binary, start[2]) ||
+			 message(binary, start[1]) == message(binary, start[2])) {
 			m = start[2];
 		} else {
 			return;
@@ -97,10 +102,10 @@ static void parseCode(void) {
 	// decode manchester
 	prev = 1;
 	for(x=0;x<MESSAGE_LENGTH;x++) {
-		if(binary[x+m] == 0) {
+		if(bitsGet(binary, x+m) == 0) {
 			prev = !prev;
 		}
-		msg[x] = prev;
+		bitsSet(msg, x, prev);
 	}
 	/*
 	 * According to http://www.osengr.org/WxShield/Downloads/Weather-Sensor-RF-Protocols.pdf
@@ -108,17 +113,17 @@ static void parseCode(void) {
 	 * battery replacement (both are not used here).
 	 * Of the next four bits the first is unused, the next three encode the channel.
 	 */
-	channel = binToDecRev(msg, 17, 19)+1;
+	channel = bitsToDecRev(msg, 17, 19)+1;
 	/*
 	 * The next twelve bits encode the temperature T
 	 * in tenth of degree Fahrenheit with an offset of 40.
 	 * The following is a simplification of F=T/10-40 and C=(F-32)*5/9.
 	 */
-	temperature = (double)binToDecRev(msg, 20, 31)/18.-40.;
+	temperature = (double)bitsToDecRev(msg, 20, 31)/18.-40.;
 	/*
 	 * The next byte has the relative humidity in percent.
 	 */
-	humidity = (double)binToDecRev(msg, 32, 39);
+	humidity = (double)bitsToDecRev(msg, 32, 39);
 	/*
 	 * The last byte contains a checksum which is not used here.
 	 */
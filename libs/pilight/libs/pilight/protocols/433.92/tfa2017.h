@@ -11,7 +11,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *tfa2017;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *tfa2017;
 void tfa2017Init(void);
 
 #endif
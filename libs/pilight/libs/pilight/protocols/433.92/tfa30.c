@@ -28,7 +28,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "tfa30.h"
 //
@@ -52,7 +52,7 @@ typedef struct settings_t {
 	struct settings_t *next;
 } settings_t;
 
-static struct settings_t *settings = NULL;
+static PROTOCOL_THREAD_LOCAL struct settings_t *settings = NULL;
 
 static int validate(void) {
 	if(tfa30->rawlen >= MIN_RAW_LENGTH && tfa30->rawlen <= MAX_RAW_LENGTH) {
@@ -64,13 +64,13 @@ static int validate(void) {
 }
 
 static void parseCode(void) {
-	int i = 0, x = 0, type = 0, id = 0, binary[MAX_RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(MAX_RAW_LENGTH/2)];
+	int type = 0, id = 0;
 	double temp_offset = 0.0, humi_offset = 0.0;
 	double humidity = 0.0, temperature = 0.0;
 	int n0 = 0, n1 = 0, n2 = 0, n3 = 0, n3b = 0;
 	int n4 = 0, n5 = 0, n6 = 0, n7 = 0, n8 = 0;
 	int n9 = 0, n10 = 0;
-	int y = 0;
 	int checksum = 1;
 
 	if(tfa30->rawlen>MAX_RAW_LENGTH) {
@@ -78,32 +78,25 @@ static void parseCode(void) {
 		return;
 	}
 
-	if(tfa30->rawlen == 80) {         // create first nibble for raw length 80
-		for(y=0;y<4;y+=1) {
-			binary[i++] = 0;
-		}
-	}
+	pulsesToBits(&tfa30->raw[0], (tfa30->rawlen+1)/2, 2, AVG_PULSE, binary);
+	bitsInvert(binary, (tfa30->rawlen+1)/2);
 
-	for(x=0;x<tfa30->rawlen;x+=2) {
-		if(tfa30->raw[x] > AVG_PULSE) {
-			binary[i++] = 0;
-		} else {
-			binary[i++] = 1;
-		}
+	if(tfa30->rawlen == 80) {         // create first nibble for raw length 80
+		binary[0] >>= 4;
 	}
 
- 	n10=binToDecRev(binary, 40, 43);
- 	n9=binToDecRev(binary, 36, 39);
-	n8=binToDecRev(binary, 32, 35);
-	n7=binToDecRev(binary, 28, 31);
-	n6=binToDecRev(binary, 24, 27);
-	n5=binToDecRev(binary, 20, 23);
-	n4=binToDecRev(binary, 16, 19);
-	n3b=binToDecRev(binary, 12, 18);
-	n3=binToDecRev(binary, 12, 15);
-	n2=binToDecRev(binary, 8, 11);
-	n1=binToDecRev(binary, 4, 7);
-	n0=binToDecRev(binary, 0, 3);
+ 	n10=bitsToDecRev(binary, 40, 43);
+ 	n9=bitsToDecRev(binary, 36, 39);
+	n8=bitsToDecRev(binary, 32, 35);
+	n7=bitsToDecRev(binary, 28, 31);
+	n6=bitsToDecRev(binary, 24, 27);
+	n5=bitsToDecRev(binary, 20, 23);
+	n4=bitsToDecRev(binary, 16, 19);
+	n3b=bitsToDecRev(binary, 12, 18);
+	n3=bitsToDecRev(binary, 12, 15);
+	n2=bitsToDecRev(binary, 8, 11);
+	n1=bitsToDecRev(binary, 4, 7);
+	n0=bitsToDecRev(binary, 0, 3);
 
 	id = n3b;
 
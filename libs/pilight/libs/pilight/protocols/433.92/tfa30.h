@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *tfa30;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *tfa30;
 void tfa30Init(void);
 
 #endif
@@ -26,7 +26,7 @@
 #include "../../core/dso.h"
 #include "../../core/log.h"
 #include "../protocol.h"
-#include "../../core/binary.h"
+#include "../../core/bits.h"
 #include "../../core/gc.h"
 #include "x10.h"
 
@@ -60,34 +60,28 @@ static void createMessage(char *id, int state) {
 }
 
 static void parseCode(void) {
-	int x = 0, y = 0, binary[RAW_LENGTH/2];
+	uint64_t binary[BITS_WORDS(RAW_LENGTH/2)];
 
 	if(x10->rawlen>RAW_LENGTH) {
 		logprintf(LOG_ERR, "x10: parsecode - invalid parameter passed %d", x10->rawlen);
 		return;
 	}
 
-	for(x=1;x<x10->rawlen-1;x+=2) {
-		if(x10->raw[x] > (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2))) {
-			binary[y++] = 1;
-		} else {
-			binary[y++] = 0;
-		}
-	}
+	pulsesToBits(&x10->raw[1], (x10->rawlen-1)/2, 2, (int)((double)AVG_PULSE_LENGTH*((double)PULSE_MULTIPLIER/2)), binary);
 
 	char id[6]= {'\0'};
-	int l = letters[binToDecRev(binary, 0, 3)];
-	int s = binary[18];
+	int l = letters[bitsToDecRev(binary, 0, 3)];
+	int s = bitsGet(binary, 18);
 	int i = 1;
-	int c1 = (binToDec(binary, 0, 7)+binToDec(binary, 8, 15));
-	int c2 = (binToDec(binary, 16, 23)+binToDec(binary, 24, 31));
-	if(binary[5] == 1) {
+	int c1 = (bitsToDec(binary, 0, 7)+bitsToDec(binary, 8, 15));
+	int c2 = (bitsToDec(binary, 16, 23)+bitsToDec(binary, 24, 31));
+	if(bitsGet(binary, 5) == 1) {
 		i += 8;
 	}
-	if(binary[17] == 1) {
+	if(bitsGet(binary, 17) == 1) {
 		i += 4;
 	}
-	i += binToDec(binary, 19, 20);
+	i += bitsToDec(binary, 19, 20);
 	if(c1 == 255 && c2 == 255) {
 		snprintf(id, sizeof(id)-1, "%c%d", (char)l, (unsigned char)i);
 		createMessage(id, s);
@@ -119,15 +113,15 @@ static void x10clearCode(void) {
 }
 
 static void createLetter(int l) {
-	int binary[255];
+	uint64_t binary[BITS_WORDS(64)];
 	int length = 0;
 	int i=0, x=0, y = 0;
 
 	for(i=0;i<17;i++) {
 		if((int)letters[i] == l) {
-			length = decToBinRev(i, binary);
+			length = decToBitsRev(i, binary);
 			for(x=0;x<=length;x++) {
-				if(binary[x]==1) {
+				if(bitsGet(binary, x)==1) {
 					y=x*2;
 					createHigh(7-(y+1),7-y);
 					createLow(23-(y+1),23-y);
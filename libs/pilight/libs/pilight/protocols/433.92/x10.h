@@ -21,7 +21,7 @@
 
 #include "../protocol.h"
 
-static struct protocol_t *x10;
+static PROTOCOL_THREAD_LOCAL struct protocol_t *x10;
 void x10Init(void);
 
 #endif
@@ -25,6 +25,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 #include "../core/pilight.h"
 #include "../core/log.h"
@@ -32,24 +39,479 @@
 
 #include "protocol_header.h"
 
-struct protocols_t *pilight_protocols = NULL;
+#ifdef PICODE_PROTOCOL_HASH
+// Perfect hash table of protocol ids and device aliases generated by protocol_hash.cmake
+#include "protocol_hash.h"
+#endif
+
+PROTOCOL_THREAD_LOCAL struct protocols_t *pilight_protocols = NULL;
 
 // Add global var to store max possible number of pulses of all protocols initiated protocols
-uint16_t pilight_maxpulses = 0;
+PROTOCOL_THREAD_LOCAL uint16_t pilight_maxpulses = 0;
 
-void protocol_init(void) {
+// Once flag of protocol_init(), per thread as registry is, so threads never share it
+static PROTOCOL_THREAD_LOCAL int pilight_initialized = 0;
+
+// Dispatch index of protocols able to decode a pulse train of a given length.
+// Candidates for rawlen "n" are pilight_dispatch[pilight_dispatch_idx[n] .. pilight_dispatch_idx[n+1]-1]
+static PROTOCOL_THREAD_LOCAL protocol_t **pilight_dispatch     = NULL;
+static PROTOCOL_THREAD_LOCAL uint16_t    *pilight_dispatch_idx = NULL;
+
+// Protocols able to decode on this thread, all if not active
+static PROTOCOL_THREAD_LOCAL protocol_filter_t pilight_filter;
+static PROTOCOL_THREAD_LOCAL int               pilight_filter_active = 0;
+
+// Bumped on each filter change, never reset, so results of a former filter are told apart
+static PROTOCOL_THREAD_LOCAL uint32_t          pilight_filter_generation = 0;
+
+// Decode instrumentation of this thread protocols enabled
+static PROTOCOL_THREAD_LOCAL int pilight_stats_enabled = 0;
+
+// Storage of registry, enough for all protocols and devices, heap is used once full.
+// Sized for protocols of this build if generated by protocol_hash.cmake, each device alias is a name
+#ifdef PICODE_PROTOCOL_HASH
+#define PROTOCOL_POOL_PROTOCOLS PROTOCOL_HASH_PROTOCOLS
+#define PROTOCOL_POOL_DEVICES   PROTOCOL_HASH_NAMES
+#else
+#define PROTOCOL_POOL_PROTOCOLS 64
+#define PROTOCOL_POOL_DEVICES   128
+#endif
+
+// Mutable protocol state of a thread, allocated by its protocol_init(), only a pointer is thread local
+typedef struct protocol_pool_t {
+  protocol_t  protocols[PROTOCOL_POOL_PROTOCOLS];
+  protocols_t nodes[PROTOCOL_POOL_PROTOCOLS];
+  uint16_t    n_protocols;
+#ifdef PICODE_PROTOCOL_HASH
+  protocol_t *by_index[PROTOCOL_HASH_PROTOCOLS];  // protocols by registry index for hashed lookup
+#endif
+} protocol_pool_t;
+
+static PROTOCOL_THREAD_LOCAL protocol_pool_t *pilight_pool = NULL;
+
+// Device aliases and options never change once registered, so the first thread registering
+// protocols adds them to shared storage and later threads reference them by registry index.
+// Shared storage is released when the last thread with protocols initialized releases them
+typedef struct protocol_shared_t {
+  struct options_t          *options;
+  struct protocol_devices_t *devices;
+} protocol_shared_t;
+
+static protocol_devices_t  pilight_shared_devices[PROTOCOL_POOL_DEVICES];
+static uint16_t            pilight_shared_n_devices = 0;
+static protocol_shared_t  *pilight_shared           = NULL;
+static uint16_t            pilight_shared_n         = 0;
+static int                 pilight_shared_ready     = 0;  // shared storage registered, guarded by lock
+static int                 pilight_shared_threads   = 0;  // threads with protocols initialized, guarded by lock
+
+// Set while this thread registers protocols again, device aliases are then skipped as options are
+static PROTOCOL_THREAD_LOCAL int pilight_shared_skip = 0;
+
+// Cleanups run at exit of a thread that used protocols, last registered first,
+// so threads ending without picode_shutdown() do not leak their registry
+#define PROTOCOL_THREAD_CLEANUPS 4
+
+static PROTOCOL_THREAD_LOCAL void (*pilight_thread_cleanups[PROTOCOL_THREAD_CLEANUPS])(void);
+static PROTOCOL_THREAD_LOCAL int   pilight_thread_n_cleanups = 0;
+
+static void protocol_thread_exit(void) {
+  while(pilight_thread_n_cleanups > 0) {
+    pilight_thread_cleanups[--pilight_thread_n_cleanups]();
+  }
+}
+
+#ifdef _WIN32
+static SRWLOCK pilight_shared_lock = SRWLOCK_INIT;
+
+static void protocol_shared_lock(void) {
+  AcquireSRWLockExclusive(&pilight_shared_lock);
+}
+
+static void protocol_shared_unlock(void) {
+  ReleaseSRWLockExclusive(&pilight_shared_lock);
+}
+
+// Fiber local storage callback is called at thread exit for threads with a value set, and by
+// FlsFree() for every thread with a value set, so cleanups only run on their own thread
+static DWORD                     pilight_thread_key     = FLS_OUT_OF_INDEXES;  // guarded by lock
+static PROTOCOL_THREAD_LOCAL int pilight_thread_exiting = 0;
+
+static VOID WINAPI protocol_thread_destructor(PVOID value) {
+  if(value == (PVOID)&pilight_thread_n_cleanups) {
+    pilight_thread_exiting = 1;
+    protocol_thread_exit();
+    pilight_thread_exiting = 0;
+  }
+}
+
+static void protocol_thread_key_create(void) {
+  if(pilight_thread_key == FLS_OUT_OF_INDEXES) {
+    pilight_thread_key = FlsAlloc(protocol_thread_destructor);
+  }
+}
+
+// Not allowed from a callback, key is then kept for next init
+static void protocol_thread_key_delete(void) {
+  if(pilight_thread_key != FLS_OUT_OF_INDEXES && !pilight_thread_exiting) {
+    FlsFree(pilight_thread_key);
+    pilight_thread_key = FLS_OUT_OF_INDEXES;
+  }
+}
+
+static void protocol_thread_key_set(void *value) {
+  if(pilight_thread_key != FLS_OUT_OF_INDEXES) {
+    FlsSetValue(pilight_thread_key, value);
+  }
+}
+#else
+static pthread_mutex_t pilight_shared_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void protocol_shared_lock(void) {
+  pthread_mutex_lock(&pilight_shared_lock);
+}
+
+static void protocol_shared_unlock(void) {
+  pthread_mutex_unlock(&pilight_shared_lock);
+}
+
+// Key destructor is called at thread exit for threads with a value set, not for main thread
+static pthread_key_t  pilight_thread_key;
+static int            pilight_thread_key_ok = 0;  // guarded by lock
+
+static void protocol_thread_destructor(void *value) {
+  protocol_thread_exit();
+}
+
+static void protocol_thread_key_create(void) {
+  if(!pilight_thread_key_ok) {
+    pilight_thread_key_ok = (pthread_key_create(&pilight_thread_key, protocol_thread_destructor) == 0);
+  }
+}
+
+static void protocol_thread_key_delete(void) {
+  if(pilight_thread_key_ok) {
+    pthread_key_delete(pilight_thread_key);
+    pilight_thread_key_ok = 0;
+  }
+}
+
+static void protocol_thread_key_set(void *value) {
+  if(pilight_thread_key_ok) {
+    pthread_setspecific(pilight_thread_key, value);
+  }
+}
+#endif
+
+// Watch exit of calling thread, once key exists while any thread has protocols initialized
+static void protocol_thread_attach(void) {
+  protocol_shared_lock();
+  protocol_thread_key_set((void *)&pilight_thread_n_cleanups);
+  protocol_shared_unlock();
+}
+
+int protocol_thread_atexit(void (*cleanup)(void)) {
+  int i = 0;
+
+  protocol_thread_attach();
+  for(i = 0; i < pilight_thread_n_cleanups; i++) {
+    if(pilight_thread_cleanups[i] == cleanup) {
+      return 0;
+    }
+  }
+  if(pilight_thread_n_cleanups >= PROTOCOL_THREAD_CLEANUPS) {
+    return -1;
+  }
+  pilight_thread_cleanups[pilight_thread_n_cleanups++] = cleanup;
+  return 0;
+}
+
+// Node is in static pool of size bytes, not allocated from heap
+static int protocol_pooled(const void *node, const void *pool, size_t size) {
+  return (uintptr_t)node >= (uintptr_t)pool && (uintptr_t)node < (uintptr_t)pool + size;
+}
+
+#ifdef PICODE_PROTOCOL_HASH
+// Hashed name lookup by registry index of pool, used only if registry matches generated table
+static PROTOCOL_THREAD_LOCAL int pilight_hash_active = 0;
+
+// Check registry against generated table, and index protocols for hashed lookup
+static void protocol_hash_init(void) {
+  protocols_t *pnode = NULL;
+  uint16_t     index = 0;
+
+  pilight_hash_active = 0;
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next, index++) {
+    if(index >= PROTOCOL_HASH_PROTOCOLS || strcmp(pnode->listener->id, protocol_hash_ids[index]) != 0) return;
+    pilight_pool->by_index[index] = pnode->listener;
+  }
+  pilight_hash_active = (index == PROTOCOL_HASH_PROTOCOLS);
+}
+
+// Hashed lookup of protocol id or device alias, NULL if not found
+static protocol_t *protocol_hash_find(const char *name) {
+  const unsigned char *c = (const unsigned char *)name;
+  uint32_t h = 2166136261u;
+  uint16_t d = 0;
+  uint16_t slot = 0;
+
+  for(; *c != 0; c++) {
+    h = (h ^ *c) * 16777619u;
+  }
+  d = protocol_hash_displace[h % PROTOCOL_HASH_BUCKETS];
+  h = (h ^ (d & 255)) * 16777619u;
+  h = (h ^ (d >> 8)) * 16777619u;
+  h ^= h >> 16;
+  slot = (uint16_t)(h % PROTOCOL_HASH_SLOTS);
+
+  if(protocol_hash_slots[slot].name == NULL || strcmp(protocol_hash_slots[slot].name, name) != 0) {
+    return NULL;
+  }
+  return pilight_pool->by_index[protocol_hash_slots[slot].index];
+}
+#endif
+
+// Build dispatch index from minrawlen/maxrawlen of all decoder protocols, keeping list order
+static void protocol_dispatch_init(void) {
+  protocols_t *pnode    = NULL;
+  protocol_t  *listener = NULL;
+  uint32_t     total    = 0;
+  uint16_t     len      = 0;
+
+  if((pilight_dispatch_idx = CALLOC((size_t)pilight_maxpulses + 2, sizeof(uint16_t))) == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Count candidates for each rawlen, stored shifted by one to accumulate offsets later
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    listener = pnode->listener;
+    if(listener->parseCode == NULL || listener->validate == NULL) continue;
+    if(pilight_filter_active && !protocol_filter_has(&pilight_filter, listener)) continue;
+    for(len = listener->minrawlen; len <= listener->maxrawlen && len <= pilight_maxpulses; len++) {
+      pilight_dispatch_idx[len+1]++;
+      total++;
+    }
+  }
+
+  for(len = 1; len <= pilight_maxpulses + 1; len++) {
+    pilight_dispatch_idx[len] += pilight_dispatch_idx[len-1];
+  }
+
+  if((pilight_dispatch = MALLOC((total > 0 ? total : 1) * sizeof(protocol_t*))) == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Fill candidates using pilight_dispatch_idx[len] as insert cursor, then restore offsets
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    listener = pnode->listener;
+    if(listener->parseCode == NULL || listener->validate == NULL) continue;
+    if(pilight_filter_active && !protocol_filter_has(&pilight_filter, listener)) continue;
+    for(len = listener->minrawlen; len <= listener->maxrawlen && len <= pilight_maxpulses; len++) {
+      pilight_dispatch[pilight_dispatch_idx[len]++] = listener;
+    }
+  }
+
+  for(len = pilight_maxpulses + 1; len > 0; len--) {
+    pilight_dispatch_idx[len] = pilight_dispatch_idx[len-1];
+  }
+  pilight_dispatch_idx[0] = 0;
+}
+
+// Call Init() of all protocols, each one sets its own thread local protocol pointer
+static void protocol_register_all(void) {
+#ifdef PICODE_PROTOCOL_SELECT
+  // Init() calls of protocols selected by PICODE_PROTOCOLS generated by protocol_select.cmake
+  #include "protocol_init_select.h"
+#else
   #include "protocol_init.h"
+#endif
+}
+
+// Register protocols of first thread, keeping their options and device aliases by registry index.
+// Called with shared lock held
+static void protocol_shared_init(void) {
+  protocols_t *pnode = NULL;
+  uint16_t     n     = 0;
+
+  protocol_register_all();
+
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    n++;
+  }
+  if((pilight_shared = MALLOC((n > 0 ? n : 1) * sizeof(protocol_shared_t))) == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    pilight_shared[pilight_shared_n].options = pnode->listener->options;
+    pilight_shared[pilight_shared_n].devices = pnode->listener->devices;
+    pilight_shared_n++;
+  }
+  pilight_shared_ready = 1;
+}
+
+// Free options and device aliases of all protocols and rewind shared pools, so next
+// thread initializing protocols registers them again. Called with shared lock held
+static void protocol_shared_free(void) {
+  protocol_devices_t *dnode = NULL;
+  protocol_devices_t *dnext = NULL;
+  uint16_t            i     = 0;
+
+  for(i = 0; i < pilight_shared_n; i++) {
+    options_delete(pilight_shared[i].options);
+    for(dnode = pilight_shared[i].devices; dnode != NULL; dnode = dnext) {
+      dnext = dnode->next;
+      if(!protocol_pooled(dnode, pilight_shared_devices, sizeof(pilight_shared_devices))) {
+        FREE(dnode);
+      }
+    }
+  }
+  options_gc();
+
+  FREE(pilight_shared);
+  pilight_shared_n         = 0;
+  pilight_shared_n_devices = 0;
+  pilight_shared_ready     = 0;
+}
+
+// Initialize protocols of calling thread, only first call until protocol_gc() does it
+void protocol_init(void) {
+  if(pilight_initialized) {
+    return;
+  }
+  // Set before registering, so a nested call never registers protocols twice
+  pilight_initialized = 1;
+
+  if((pilight_pool = CALLOC(1, sizeof(protocol_pool_t))) == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // First thread registers to shared storage and creates thread exit key,
+  // others register again without options and devices
+  protocol_shared_lock();
+  if(!pilight_shared_ready) {
+    protocol_shared_init();
+  }
+  protocol_thread_key_create();
+  pilight_shared_threads++;
+  protocol_shared_unlock();
+
+  // Release registry when this thread ends
+  protocol_thread_atexit(protocol_gc);
+
+  if(pilight_protocols == NULL) {
+    options_skip(1);
+    pilight_shared_skip = 1;
+    protocol_register_all();
+    pilight_shared_skip = 0;
+    options_skip(0);
+  }
 
   protocol_t*         listener = NULL; 
   protocols_t*        pnode    = pilight_protocols;
+  uint16_t            index    = 0;
 
   // Locate max possible number of pulses of all protocols initiated protocols
   while (pnode != NULL) {
     listener = pnode->listener;
+    if (index < pilight_shared_n) {
+      listener->options = pilight_shared[index].options;
+      listener->devices = pilight_shared[index].devices;
+    }
+    listener->index = index++;
     if (listener->maxrawlen > pilight_maxpulses ) pilight_maxpulses = listener->maxrawlen;
     //printf("Protocol: %-20s maxrawlen: %3d\n",listener->id,listener->maxrawlen);
     pnode = pnode->next;
   }
+
+  protocol_dispatch_init();
+
+#ifdef PICODE_PROTOCOL_HASH
+  protocol_hash_init();
+#endif
+}
+
+// Release protocols of calling thread: run their gc, free nodes and dispatch index, and reset
+// registry so next call initializes protocols again. Last thread frees shared options and devices,
+// and deletes thread exit key
+void protocol_gc(void) {
+  protocols_t        *pnode    = pilight_protocols;
+  protocols_t        *next     = NULL;
+  protocol_t         *listener = NULL;
+
+  while(pnode != NULL) {
+    next = pnode->next;
+    listener = pnode->listener;
+    if(listener->gc != NULL) {
+      listener->gc();
+    }
+    if(listener->message != NULL) {
+      json_delete(listener->message);
+    }
+    if(pilight_pool == NULL || !protocol_pooled(pnode, pilight_pool->nodes, sizeof(pilight_pool->nodes))) {
+      FREE(listener);
+      FREE(pnode);
+    }
+    pnode = next;
+  }
+
+  FREE(pilight_dispatch);
+  FREE(pilight_dispatch_idx);
+  FREE(pilight_pool);
+
+  // Thread exit is no longer watched, so no callback is left into an unloaded library
+  if(pilight_initialized) {
+    protocol_shared_lock();
+    protocol_thread_key_set(NULL);
+    if(--pilight_shared_threads == 0) {
+      if(pilight_shared_ready) {
+        protocol_shared_free();
+      }
+      protocol_thread_key_delete();
+    }
+    protocol_shared_unlock();
+  }
+
+  pilight_protocols        = NULL;
+  pilight_maxpulses        = 0;
+  pilight_initialized      = 0;
+  pilight_filter_active    = 0;
+  pilight_filter_generation++;
+  pilight_stats_enabled    = 0;
+
+#ifdef PICODE_PROTOCOL_HASH
+  pilight_hash_active = 0;
+#endif
+}
+
+// Find protocol by id or device alias, NULL if not found
+protocol_t *protocol_find(const char *name) {
+  protocols_t        *pnode = NULL;
+  protocol_devices_t *dnode = NULL;
+
+  if (pilight_protocols==NULL){protocol_init();}
+
+#ifdef PICODE_PROTOCOL_HASH
+  if(pilight_hash_active) {
+    return protocol_hash_find(name);
+  }
+#endif
+
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    if(strcmp(pnode->listener->id, name) == 0) {
+      return pnode->listener;
+    }
+  }
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    for(dnode = pnode->listener->devices; dnode != NULL; dnode = dnode->next) {
+      if(strcmp(dnode->id, name) == 0) {
+        return pnode->listener;
+      }
+    }
+  }
+  return NULL;
 }
 
 // Getter for max possible number of pulses of all protocols initiated protocols
@@ -58,8 +520,214 @@ uint16_t protocol_maxrawlen(void){
   return pilight_maxpulses;
 }
 
+// Getter for protocols able to decode a pulse train of rawlen pulses, returns number of candidates
+uint16_t protocol_candidates(uint16_t rawlen, protocol_t ***candidates) {
+  if (pilight_protocols==NULL){protocol_init();}
+  if (rawlen > pilight_maxpulses) {
+    *candidates = NULL;
+    return 0;
+  }
+  *candidates = &pilight_dispatch[pilight_dispatch_idx[rawlen]];
+  return (uint16_t)(pilight_dispatch_idx[rawlen+1] - pilight_dispatch_idx[rawlen]);
+}
+
+void protocol_filter_add_protocol(protocol_filter_t *filter, const protocol_t *proto) {
+  if(proto->index < PROTOCOL_FILTER_WORDS * 64) {
+    filter->bits[proto->index / 64] |= (uint64_t)1 << (proto->index % 64);
+  }
+}
+
+void protocol_filter_clear(protocol_filter_t *filter) {
+  memset(filter, 0, sizeof(*filter));
+}
+
+// Add protocol by id or device alias, returns number of protocols added
+int protocol_filter_add(protocol_filter_t *filter, const char *name) {
+  protocol_t *proto = protocol_find(name);
+
+  if(proto == NULL) {
+    return 0;
+  }
+  protocol_filter_add_protocol(filter, proto);
+  return 1;
+}
+
+// Add protocols of a device type, returns number of protocols added
+int protocol_filter_add_devtype(protocol_filter_t *filter, devtype_t devtype) {
+  protocols_t *pnode = NULL;
+  int          n     = 0;
+
+  if (pilight_protocols==NULL){protocol_init();}
+
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    if(pnode->listener->devtype == devtype) {
+      protocol_filter_add_protocol(filter, pnode->listener);
+      n++;
+    }
+  }
+  return n;
+}
+
+// Add protocols of a hardware type, returns number of protocols added
+int protocol_filter_add_hwtype(protocol_filter_t *filter, hwtype_t hwtype) {
+  protocols_t *pnode = NULL;
+  int          n     = 0;
+
+  if (pilight_protocols==NULL){protocol_init();}
+
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    if(pnode->listener->hwtype == hwtype) {
+      protocol_filter_add_protocol(filter, pnode->listener);
+      n++;
+    }
+  }
+  return n;
+}
+
+int protocol_filter_has(const protocol_filter_t *filter, const protocol_t *proto) {
+  if(proto->index >= PROTOCOL_FILTER_WORDS * 64) return 0;
+  return (filter->bits[proto->index / 64] >> (proto->index % 64)) & 1;
+}
+
+// Rebuild dispatch index of calling thread with protocols of filter, all protocols if NULL
+void protocol_filter_set(const protocol_filter_t *filter) {
+  if (pilight_protocols==NULL){protocol_init();}
+
+  if(filter != NULL) {
+    pilight_filter = *filter;
+    pilight_filter_active = 1;
+  } else {
+    pilight_filter_active = 0;
+  }
+  pilight_filter_generation++;
+
+  FREE(pilight_dispatch);
+  FREE(pilight_dispatch_idx);
+  protocol_dispatch_init();
+}
+
+uint32_t protocol_filter_generation(void) {
+  return pilight_filter_generation;
+}
+
+// Clock in nanoseconds for decode instrumentation, monotonic if available
+static uint64_t protocol_stats_clock(void) {
+  struct timespec ts;
+#ifdef _WIN32
+  timespec_get(&ts, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void protocol_stats_enable(int enable) {
+  pilight_stats_enabled = (enable != 0);
+}
+
+int protocol_stats_enabled(void) {
+  return pilight_stats_enabled;
+}
+
+void protocol_stats_reset(void) {
+  protocols_t *pnode = NULL;
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    memset(&pnode->listener->stats, 0, sizeof(pnode->listener->stats));
+  }
+}
+
+// Copy counters of up to max protocols in list order, returns number of protocols copied
+uint16_t protocol_stats_snapshot(protocol_stats_entry_t *entries, uint16_t max) {
+  protocols_t *pnode = NULL;
+  uint16_t     n     = 0;
+
+  if (pilight_protocols==NULL){protocol_init();}
+
+  for(pnode = pilight_protocols; pnode != NULL && n < max; pnode = pnode->next) {
+    entries[n].id    = pnode->listener->id;
+    entries[n].stats = pnode->listener->stats;
+    n++;
+  }
+  return n;
+}
+
+// Text table of protocols with validate() calls. Must be free() after use
+char *protocol_stats_dump(void) {
+  protocols_t *pnode = NULL;
+  size_t       size  = 128;
+  size_t       len   = 0;
+  char        *dump  = NULL;
+
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    size += 128;
+  }
+
+  if((dump = MALLOC(size)) == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  len += (size_t)snprintf(dump + len, size - len, "%-24s %12s %12s %12s %14s %14s\n",
+    "protocol", "validate", "passes", "matches", "validate_ns", "parse_ns");
+
+  for(pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    protocol_stats_t *stats = &pnode->listener->stats;
+    if(stats->validate_calls == 0 || len >= size) continue;
+    len += (size_t)snprintf(dump + len, size - len, "%-24s %12llu %12llu %12llu %14llu %14llu\n",
+      pnode->listener->id,
+      (unsigned long long)stats->validate_calls,
+      (unsigned long long)stats->validate_passes,
+      (unsigned long long)stats->parse_matches,
+      (unsigned long long)stats->validate_ns,
+      (unsigned long long)stats->parse_ns);
+  }
+  return dump;
+}
+
+// Call validate() updating counters if instrumentation is enabled
+int protocol_validate(protocol_t *proto) {
+  uint64_t start = 0;
+  int      ret   = 0;
+
+  if(!pilight_stats_enabled) {
+    return proto->validate();
+  }
+
+  start = protocol_stats_clock();
+  ret = proto->validate();
+  proto->stats.validate_ns += protocol_stats_clock() - start;
+  proto->stats.validate_calls++;
+  if(ret == 0) {
+    proto->stats.validate_passes++;
+  }
+  return ret;
+}
+
+// Call parseCode() updating counters if instrumentation is enabled
+void protocol_parse(protocol_t *proto) {
+  uint64_t start = 0;
+
+  if(!pilight_stats_enabled) {
+    proto->parseCode();
+    return;
+  }
+
+  start = protocol_stats_clock();
+  proto->parseCode();
+  proto->stats.parse_ns += protocol_stats_clock() - start;
+  if(proto->message != NULL) {
+    proto->stats.parse_matches++;
+  }
+}
+
 void protocol_register(protocol_t **proto) {
-  if((*proto = MALLOC(sizeof(struct protocol_t))) == NULL) {
+  struct protocols_t *pnode = NULL;
+
+  if(pilight_pool != NULL && pilight_pool->n_protocols < PROTOCOL_POOL_PROTOCOLS) {
+    *proto = &pilight_pool->protocols[pilight_pool->n_protocols];
+    pnode  = &pilight_pool->nodes[pilight_pool->n_protocols];
+    pilight_pool->n_protocols++;
+  } else if((*proto = MALLOC(sizeof(struct protocol_t))) == NULL || (pnode = MALLOC(sizeof(struct protocols_t))) == NULL) {
     fprintf(stderr, "out of memory\n");
     exit(EXIT_FAILURE);
   }
@@ -73,6 +741,7 @@ void protocol_register(protocol_t **proto) {
   (*proto)->maxgaplen = 0;
   (*proto)->txrpt = 10;
   (*proto)->rxrpt = 1;
+  (*proto)->randomopt = NULL;
   (*proto)->hwtype = NONE;
   //(*proto)->multipleId = 1;
   //(*proto)->config = 1;
@@ -93,11 +762,8 @@ void protocol_register(protocol_t **proto) {
 
   (*proto)->raw = NULL;
 
-  struct protocols_t *pnode = MALLOC(sizeof(struct protocols_t));
-  if(pnode == NULL) {
-    fprintf(stderr, "out of memory\n");
-    exit(EXIT_FAILURE);
-  }
+  memset(&(*proto)->stats, 0, sizeof((*proto)->stats));
+
   pnode->listener = *proto;
   pnode->next = pilight_protocols;
   pilight_protocols = pnode;
@@ -107,27 +773,25 @@ void protocol_set_id(protocol_t *proto, char *id) {
   proto->id = id;
 }
 
+// Id and desc are referenced, not copied: they must be string literals
 void protocol_device_add(protocol_t *proto, const char *id, const char *desc) {
 	//logprintf(LOG_STACK, "%s(...)", __FUNCTION__);
 
-	struct protocol_devices_t *dnode = MALLOC(sizeof(struct protocol_devices_t));
+	struct protocol_devices_t *dnode = NULL;
 
-	if(dnode == NULL) {
-		fprintf(stderr, "out of memory\n");
-		exit(EXIT_FAILURE);
+	if(pilight_shared_skip) {
+		return;
 	}
 
-	if((dnode->id = MALLOC(strlen(id)+1)) == NULL) {
+	if(pilight_shared_n_devices < PROTOCOL_POOL_DEVICES) {
+		dnode = &pilight_shared_devices[pilight_shared_n_devices++];
+	} else if((dnode = MALLOC(sizeof(struct protocol_devices_t))) == NULL) {
 		fprintf(stderr, "out of memory\n");
 		exit(EXIT_FAILURE);
 	}
-	strcpy(dnode->id, id);
 
-	if((dnode->desc = MALLOC(strlen(desc)+1)) == NULL) {
-		fprintf(stderr, "out of memory\n");
-		exit(EXIT_FAILURE);
-	}
-	strcpy(dnode->desc, desc);
+	dnode->id   = id;
+	dnode->desc = desc;
 
 	dnode->next	= proto->devices;
 	proto->devices = dnode;
@@ -29,6 +29,16 @@
 #include "../core/json.h"
 #include "../core/options.h"
 
+// Protocol state (registry, raw pulses, messages) is kept per thread,
+// so each thread decodes and encodes with its own protocol instances
+#if defined(__cplusplus)
+  #define PROTOCOL_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+  #define PROTOCOL_THREAD_LOCAL __declspec(thread)
+#else
+  #define PROTOCOL_THREAD_LOCAL _Thread_local
+#endif
+
 // from ../config/hardware.h
 typedef enum {
   HWINTERNAL = -1,
@@ -65,11 +75,32 @@ typedef enum {
 } devtype_t;
 
 typedef struct protocol_devices_t {
-	char *id;
-	char *desc;
+	const char *id;
+	const char *desc;
 	struct protocol_devices_t *next;
 } protocol_devices_t;
 
+// Decode instrumentation counters, see protocol_stats_enable()
+typedef struct protocol_stats_t {
+  uint64_t validate_calls;   // validate() calls
+  uint64_t validate_passes;  // validate() calls returning 0
+  uint64_t parse_matches;    // parseCode() calls producing a message
+  uint64_t validate_ns;      // nanoseconds spent in validate()
+  uint64_t parse_ns;         // nanoseconds spent in parseCode()
+} protocol_stats_t;
+
+typedef struct protocol_stats_entry_t {
+  const char *id;
+  protocol_stats_t stats;
+} protocol_stats_entry_t;
+
+// Set of protocols by registry index, see protocol_filter_set()
+#define PROTOCOL_FILTER_WORDS 4
+
+typedef struct protocol_filter_t {
+  uint64_t bits[PROTOCOL_FILTER_WORDS];
+} protocol_filter_t;
+
 typedef struct protocol_t {
   char *id;
   uint16_t rawlen;
@@ -79,6 +110,7 @@ typedef struct protocol_t {
   uint32_t maxgaplen;
   uint8_t txrpt;
   uint8_t rxrpt;
+  const char *randomopt; // option createCode() picks at random when not given, or NULL
   //short multipleId;
   //short config;
   //short masterOnly;
@@ -108,6 +140,9 @@ typedef struct protocol_t {
   void (*printHelp)(void);
   void (*gc)(void);
   //void (*threadGC)(void);
+
+  protocol_stats_t stats;
+  uint16_t index; // position in registry, bit of protocol_filter_t
 } protocol_t;
 
 typedef struct protocols_t {
@@ -116,12 +151,47 @@ typedef struct protocols_t {
   struct protocols_t *next;
 } protocols_t;
 
-extern struct protocols_t *pilight_protocols;
+extern PROTOCOL_THREAD_LOCAL struct protocols_t *pilight_protocols;
 
 // Add getter for max possible number of pulses of all protocols initiated protocols
 uint16_t protocol_maxrawlen(void);
 
+// Run cleanup at exit of calling thread, once per function, other than main thread. Returns 0 if registered
+int protocol_thread_atexit(void (*cleanup)(void));
+
+// Getter for protocols able to decode a pulse train of rawlen pulses (minrawlen <= rawlen <= maxrawlen)
+uint16_t protocol_candidates(uint16_t rawlen, protocol_t ***candidates);
+
+// Decode instrumentation of calling thread protocols, disabled by default
+void protocol_stats_enable(int enable);
+int protocol_stats_enabled(void);
+void protocol_stats_reset(void);
+// Copy counters of up to max protocols in list order, returns number of protocols copied
+uint16_t protocol_stats_snapshot(protocol_stats_entry_t *entries, uint16_t max);
+// Text table of protocols with validate() calls. Must be free() after use
+char *protocol_stats_dump(void);
+
+// Find protocol by id or device alias, NULL if not found. Hashed lookup if built with PICODE_PROTOCOL_HASH
+protocol_t *protocol_find(const char *name);
+
+// Protocol filter, built from protocol ids or device aliases, device or hardware types
+void protocol_filter_clear(protocol_filter_t *filter);
+void protocol_filter_add_protocol(protocol_filter_t *filter, const protocol_t *proto);
+int protocol_filter_add(protocol_filter_t *filter, const char *name);
+int protocol_filter_add_devtype(protocol_filter_t *filter, devtype_t devtype);
+int protocol_filter_add_hwtype(protocol_filter_t *filter, hwtype_t hwtype);
+int protocol_filter_has(const protocol_filter_t *filter, const protocol_t *proto);
+// Decode only protocols of filter on calling thread, all protocols if NULL
+void protocol_filter_set(const protocol_filter_t *filter);
+// Generation of calling thread filter, changed by each protocol_filter_set() or protocol_gc()
+uint32_t protocol_filter_generation(void);
+
+// Call validate() and parseCode() updating counters if instrumentation is enabled
+int protocol_validate(protocol_t *proto);
+void protocol_parse(protocol_t *proto);
+
 void protocol_init(void);
+void protocol_gc(void);
 void protocol_set_id(protocol_t *proto, char *id);
 void protocol_register(protocol_t **proto);
 
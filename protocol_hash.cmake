@@ -0,0 +1,213 @@
+# PiCode Library
+# https://github.com/latchdevel/PiCode
+# Copyright (c) 2021-2022 Jorge Rivera. All right reserved.
+# License GNU Lesser General Public License v3.0.
+#
+# Generate a perfect hash table of protocol ids and device aliases.
+#
+# Protocols are taken from the Init() calls of protocol_init.h, or of the
+# INIT_HEADER generated by protocol_select.cmake if given, and their id
+# and device aliases from protocol_set_id() and protocol_device_add() calls of
+# the protocol sources. Every name is mapped to the registry index of its
+# protocol, the position in pilight_protocols list, which is the reverse of
+# the Init() calls order because protocol_register() prepends.
+#
+# Hash and displace: FNV-1a of a name selects a bucket, and the displacement
+# of the bucket, hashed into the FNV-1a value, selects a table slot. High
+# bits are folded into the value before the slot modulo, as modulo of table
+# sizes dividing 2^32-1, like 17, is nearly linear in FNV-1a steps. Buckets
+# are placed from largest to smallest, searching a displacement that puts all
+# their names in free slots, so each slot holds at most one name.
+#
+# Usage: cmake -DPROTOCOLS_DIR=<protocols directory> [-DINIT_HEADER=<init calls header>] -DOUTPUT=<header> -P protocol_hash.cmake
+
+cmake_minimum_required(VERSION 3.18)
+
+if(NOT PROTOCOLS_DIR OR NOT OUTPUT)
+  message(FATAL_ERROR "Usage: cmake -DPROTOCOLS_DIR=<dir> -DOUTPUT=<header> -P protocol_hash.cmake")
+endif()
+if(NOT INIT_HEADER)
+  set(INIT_HEADER "${PROTOCOLS_DIR}/protocol_init.h")
+endif()
+
+set(FNV_BASIS 2166136261)
+set(FNV_PRIME 16777619)
+set(MASK32    0xFFFFFFFF)
+
+# FNV-1a hash of name
+function(fnv1a name result)
+  set(h ${FNV_BASIS})
+  string(HEX "${name}" hex)
+  string(LENGTH "${hex}" len)
+  set(i 0)
+  while(i LESS len)
+    string(SUBSTRING "${hex}" ${i} 2 byte)
+    math(EXPR h "((${h} ^ 0x${byte}) * ${FNV_PRIME}) & ${MASK32}")
+    math(EXPR i "${i} + 2")
+  endwhile()
+  set(${result} ${h} PARENT_SCOPE)
+endfunction()
+
+# Slot of a name hash with displacement
+function(displace_slot h d slots result)
+  math(EXPR h "((${h} ^ (${d} & 255)) * ${FNV_PRIME}) & ${MASK32}")
+  math(EXPR h "((${h} ^ (${d} >> 8)) * ${FNV_PRIME}) & ${MASK32}")
+  math(EXPR h "${h} ^ (${h} >> 16)")
+  math(EXPR slot "${h} % ${slots}")
+  set(${result} ${slot} PARENT_SCOPE)
+endfunction()
+
+# Init() functions in registration order
+file(STRINGS "${INIT_HEADER}" init_lines REGEX "^[ \t]*[A-Za-z0-9_]+Init\\(\\);")
+set(init_calls "")
+foreach(line IN LISTS init_lines)
+  string(REGEX REPLACE "^[ \t]*([A-Za-z0-9_]+Init)\\(\\);.*$" "\\1" init "${line}")
+  list(APPEND init_calls ${init})
+endforeach()
+list(LENGTH init_calls n_protocols)
+if(n_protocols EQUAL 0)
+  message(FATAL_ERROR "No protocol Init() calls found in ${INIT_HEADER}")
+endif()
+
+# Protocol id and device aliases of each Init() function
+file(GLOB sources "${PROTOCOLS_DIR}/433.92/*.c")
+foreach(source IN LISTS sources)
+  file(READ "${source}" content)
+  string(REGEX MATCH "void[ \t]+([A-Za-z0-9_]+Init)[ \t]*\\([ \t]*void[ \t]*\\)" match "${content}")
+  if(NOT match)
+    continue()
+  endif()
+  set(init ${CMAKE_MATCH_1})
+  string(REGEX MATCH "protocol_set_id\\([A-Za-z0-9_]+,[ \t]*\"([^\"]+)\"" match "${content}")
+  set(ID_${init} ${CMAKE_MATCH_1})
+  string(REGEX MATCHALL "protocol_device_add\\([A-Za-z0-9_]+,[ \t]*\"[^\"]+\"" devices "${content}")
+  set(ALIASES_${init} "")
+  foreach(device IN LISTS devices)
+    string(REGEX REPLACE "^.*\"([^\"]+)\"$" "\\1" alias "${device}")
+    list(APPEND ALIASES_${init} ${alias})
+  endforeach()
+endforeach()
+
+# Names and registry index of their protocol
+set(names "")
+set(ids "")
+set(k 0)
+foreach(init IN LISTS init_calls)
+  if(NOT ID_${init})
+    message(FATAL_ERROR "No protocol source defines ${init}()")
+  endif()
+  math(EXPR index "${n_protocols} - 1 - ${k}")
+  list(PREPEND ids ${ID_${init}})
+  foreach(name IN ITEMS ${ID_${init}} ${ALIASES_${init}})
+    if(DEFINED INDEX_${name})
+      if(NOT INDEX_${name} EQUAL index)
+        message(FATAL_ERROR "Name \"${name}\" is used by more than one protocol")
+      endif()
+      continue()
+    endif()
+    set(INDEX_${name} ${index})
+    list(APPEND names ${name})
+  endforeach()
+  math(EXPR k "${k} + 1")
+endforeach()
+
+list(LENGTH names n_names)
+math(EXPR n_slots   "${n_names} + ${n_names} / 4 + 1")
+math(EXPR n_buckets "(${n_names} + 2) / 3")
+
+# Names of each bucket
+set(max_size 0)
+foreach(name IN LISTS names)
+  fnv1a("${name}" h)
+  set(HASH_${name} ${h})
+  math(EXPR bucket "${h} % ${n_buckets}")
+  list(APPEND BUCKET_${bucket} ${name})
+  list(LENGTH BUCKET_${bucket} size)
+  if(size GREATER max_size)
+    set(max_size ${size})
+  endif()
+endforeach()
+
+# Displacement of each bucket, largest buckets first
+math(EXPR last_bucket "${n_buckets} - 1")
+math(EXPR last_slot   "${n_slots} - 1")
+foreach(bucket RANGE ${last_bucket})
+  set(DISPLACE_${bucket} 0)
+endforeach()
+set(size ${max_size})
+while(size GREATER 0)
+  foreach(bucket RANGE ${last_bucket})
+    list(LENGTH BUCKET_${bucket} bucket_size)
+    if(NOT bucket_size EQUAL size)
+      continue()
+    endif()
+    set(d 0)
+    while(TRUE)
+      math(EXPR d "${d} + 1")
+      if(d GREATER 65535)
+        message(FATAL_ERROR "No perfect hash displacement found for bucket ${bucket}")
+      endif()
+      set(taken "")
+      set(found TRUE)
+      foreach(name IN LISTS BUCKET_${bucket})
+        displace_slot(${HASH_${name}} ${d} ${n_slots} slot)
+        if(DEFINED SLOT_${slot} OR slot IN_LIST taken)
+          set(found FALSE)
+          break()
+        endif()
+        list(APPEND taken ${slot})
+      endforeach()
+      if(found)
+        break()
+      endif()
+    endwhile()
+    set(DISPLACE_${bucket} ${d})
+    foreach(name IN LISTS BUCKET_${bucket})
+      displace_slot(${HASH_${name}} ${d} ${n_slots} slot)
+      set(SLOT_${slot} ${name})
+    endforeach()
+  endforeach()
+  math(EXPR size "${size} - 1")
+endwhile()
+
+# Header
+set(header "/* Generated by protocol_hash.cmake from protocol Init() calls and protocol sources, do not edit */\n\n")
+string(APPEND header "#define PROTOCOL_HASH_PROTOCOLS ${n_protocols}\n")
+string(APPEND header "#define PROTOCOL_HASH_NAMES     ${n_names}\n")
+string(APPEND header "#define PROTOCOL_HASH_BUCKETS   ${n_buckets}\n")
+string(APPEND header "#define PROTOCOL_HASH_SLOTS     ${n_slots}\n\n")
+
+string(APPEND header "// Protocol ids by registry index\n")
+string(APPEND header "static const char *const protocol_hash_ids[PROTOCOL_HASH_PROTOCOLS] = {\n")
+foreach(id IN LISTS ids)
+  string(APPEND header "  \"${id}\",\n")
+endforeach()
+string(APPEND header "};\n\n")
+
+string(APPEND header "// Displacement of each bucket\n")
+string(APPEND header "static const uint16_t protocol_hash_displace[PROTOCOL_HASH_BUCKETS] = {\n")
+foreach(bucket RANGE ${last_bucket})
+  string(APPEND header "  ${DISPLACE_${bucket}},\n")
+endforeach()
+string(APPEND header "};\n\n")
+
+string(APPEND header "// Name and registry index of protocol of each slot, NULL name if empty\n")
+string(APPEND header "static const struct { const char *name; uint16_t index; } protocol_hash_slots[PROTOCOL_HASH_SLOTS] = {\n")
+foreach(slot RANGE ${last_slot})
+  if(DEFINED SLOT_${slot})
+    set(name ${SLOT_${slot}})
+    string(APPEND header "  { \"${name}\", ${INDEX_${name}} },\n")
+  else()
+    string(APPEND header "  { NULL, 0 },\n")
+  endif()
+endforeach()
+string(APPEND header "};\n")
+
+# Only rewrite if changed, so dependent sources are not rebuilt
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" previous)
+  if(previous STREQUAL header)
+    return()
+  endif()
+endif()
+file(WRITE "${OUTPUT}" "${header}")
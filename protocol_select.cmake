@@ -0,0 +1,86 @@
+# PiCode Library
+# https://github.com/latchdevel/PiCode
+# Copyright (c) 2021-2022 Jorge Rivera. All right reserved.
+# License GNU Lesser General Public License v3.0.
+#
+# Compile-time protocol selection, included from CMakeLists.txt.
+#
+# If PICODE_PROTOCOLS is set to a list of protocol ids, like
+# "arctech_switch;ev1527;tfa", only their sources are compiled and only
+# their Init() calls are generated, keeping the protocol_init.h order, into
+# PROTOCOL_INIT_HEADER. Protocol name hash and dispatch index are built from
+# the generated Init() calls, so only the listed protocols are registered.
+#
+# Input:  PICODE_PROTOCOLS, PROTOCOL_DIR, PROTOCOLS (all protocol sources)
+# Output: PROTOCOLS (selected sources), PROTOCOL_INIT_HEADER
+
+set(PROTOCOL_INIT_HEADER ${PROTOCOL_DIR}/protocol_init.h)
+
+if(NOT PICODE_PROTOCOLS)
+  return()
+endif()
+
+# Source and Init() function of each protocol id
+foreach(source IN LISTS PROTOCOLS)
+  file(READ "${source}" content)
+  string(REGEX MATCH "void[ \t]+([A-Za-z0-9_]+Init)[ \t]*\\([ \t]*void[ \t]*\\)" match "${content}")
+  if(NOT match)
+    continue()
+  endif()
+  set(init ${CMAKE_MATCH_1})
+  string(REGEX MATCH "protocol_set_id\\([A-Za-z0-9_]+,[ \t]*\"([^\"]+)\"" match "${content}")
+  if(match)
+    set(SELECT_SOURCE_${CMAKE_MATCH_1} ${source})
+    set(SELECT_INIT_${CMAKE_MATCH_1} ${init})
+  endif()
+endforeach()
+
+# Init() calls of protocol_init.h
+file(STRINGS "${PROTOCOL_DIR}/protocol_init.h" init_lines REGEX "^[ \t]*[A-Za-z0-9_]+Init\\(\\);")
+set(init_calls "")
+foreach(line IN LISTS init_lines)
+  string(REGEX REPLACE "^[ \t]*([A-Za-z0-9_]+Init)\\(\\);.*$" "\\1" init "${line}")
+  list(APPEND init_calls ${init})
+endforeach()
+
+# Sources and Init() functions of listed protocols
+set(selected_sources "")
+set(selected_inits "")
+foreach(id IN LISTS PICODE_PROTOCOLS)
+  if(NOT DEFINED SELECT_SOURCE_${id})
+    message(FATAL_ERROR "PICODE_PROTOCOLS: unknown protocol id \"${id}\"")
+  endif()
+  if(NOT SELECT_INIT_${id} IN_LIST init_calls)
+    message(FATAL_ERROR "PICODE_PROTOCOLS: protocol \"${id}\" is not registered by protocol_init.h")
+  endif()
+  list(APPEND selected_sources ${SELECT_SOURCE_${id}})
+  list(APPEND selected_inits ${SELECT_INIT_${id}})
+endforeach()
+list(REMOVE_DUPLICATES selected_sources)
+set(PROTOCOLS ${selected_sources})
+
+# Init() calls in protocol_init.h order
+set(header "/* Generated by protocol_select.cmake from protocol_init.h and PICODE_PROTOCOLS, do not edit */\n\n")
+set(n_selected 0)
+foreach(init IN LISTS init_calls)
+  if(init IN_LIST selected_inits)
+    string(APPEND header "${init}();\n")
+    math(EXPR n_selected "${n_selected} + 1")
+  endif()
+endforeach()
+
+set(PROTOCOL_INIT_HEADER ${CMAKE_CURRENT_BINARY_DIR}/protocol_init_select.h)
+
+# Only rewrite if changed, so dependent sources are not rebuilt
+set(previous "")
+if(EXISTS "${PROTOCOL_INIT_HEADER}")
+  file(READ "${PROTOCOL_INIT_HEADER}" previous)
+endif()
+if(NOT previous STREQUAL header)
+  file(WRITE "${PROTOCOL_INIT_HEADER}" "${header}")
+endif()
+
+# Configure again if protocol_init.h changes
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${PROTOCOL_DIR}/protocol_init.h)
+
+MESSAGE( STATUS "Protocols: ${n_selected} selected by PICODE_PROTOCOLS" )
@@ -20,15 +20,33 @@
 /* Set a default object instance */
 class PiCode PiCode;
 
+/* Packed bits helpers checked at compile time against bits.h results on known words,
+   signed values wider than int results of bits.h as bitsToDec() sign extended */
+static constexpr bool bitsCase(uint64_t word, unsigned int s, unsigned int e, uint64_t dec, uint64_t dec_rev, int64_t sig, int64_t sig_rev){
+  return PiCode::bitsToDec(word, s, e) == dec && PiCode::bitsToDecRev(word, s, e) == dec_rev &&
+         PiCode::bitsToSigned(word, s, e) == sig && PiCode::bitsToSignedRev(word, s, e) == sig_rev &&
+         PiCode::bitsFromDec(word, s, e, dec) == word && PiCode::bitsFromDecRev(0, s, e, dec_rev) == (word & PiCode::bitsMask(s, e));
+}
+
+static_assert(bitsCase(0xF0E1D2C3B4A59687ULL,  0, 63, 0xE169A52DC34B870FULL, 0xF0E1D2C3B4A59687ULL, -2204048926652528881LL, -1089357896855742841LL), "bits 0..63");
+static_assert(bitsCase(0xF0E1D2C3B4A59687ULL,  1, 63, 0x70B4D296E1A5C387ULL, 0x70E1D2C3B4A59687ULL, -1102024463326264441LL, -1089357896855742841LL), "bits 1..63");
+static_assert(bitsCase(0xF0E1D2C3B4A59687ULL,  4, 11, 0x0000000000000070ULL, 0x000000000000000EULL, 112LL, 14LL), "bits 4..11");
+static_assert(bitsCase(0xF0E1D2C3B4A59687ULL, 60, 63, 0x000000000000000EULL, 0x0000000000000007ULL, -2LL, 7LL), "bits 60..63");
+static_assert(bitsCase(0xF0E1D2C3B4A59687ULL,  0,  0, 0x0000000000000001ULL, 0x0000000000000001ULL, -1LL, -1LL), "bit 0");
+static_assert(bitsCase(0xF0E1D2C3B4A59687ULL,  8, 47, 0x000000A52DC34B87ULL, 0x000000E1D2C3B4A5ULL, -390074250361LL, -129607945051LL), "bits 8..47");
+static_assert(bitsCase(0x8000000000000001ULL,  0, 63, 0x8000000000000001ULL, 0x8000000000000001ULL, -9223372036854775807LL, -9223372036854775807LL), "bits 0..63");
+static_assert(bitsCase(0x8000000000000001ULL,  1, 63, 0x4000000000000000ULL, 0x0000000000000001ULL, -4611686018427387904LL, 1LL), "bits 1..63");
+static_assert(bitsCase(0x8000000000000001ULL,  0, 62, 0x0000000000000001ULL, 0x4000000000000000ULL, 1LL, -4611686018427387904LL), "bits 0..62");
+static_assert(bitsCase(0x5A5A5A5A0F0F0F0FULL,  4, 11, 0x00000000000000A5ULL, 0x00000000000000A5ULL, -91LL, -91LL), "bits 4..11");
+static_assert(bitsCase(0x5A5A5A5A0F0F0F0FULL, 20, 49, 0x000000000F0F05A5ULL, 0x0000000029683C3CULL, 252642725LL, -379044804LL), "bits 20..49");
+
 /* Class PiCode                                                              */
 /* ------------------------------------------------------------------------- */
 
 /* Constructor */
 PiCode::PiCode(){
-  /* Call protocol_init() only one time by default object instance */
-  if (cPiCode::pilight_protocols == nullptr){
-      cPiCode::protocol_init();
-  }
+  /* Initialize protocols of constructing thread, only once */
+  cPiCode::picode_init();
 }
 
 /* Public class methods call pure C functions library                        */
@@ -44,6 +62,11 @@ char* PiCode::pulseTrainToString(const uint32_t* pulses, uint16_t maxlength, uin
   return cPiCode::pulseTrainToString(pulses, maxlength, repeats);
 }
 
+/* Convert pulses and length to pilight string format in buffer. Returns string length if success */
+int PiCode::pulseTrainToBuffer(const uint32_t* pulses, uint16_t length, char* buffer, size_t size, uint8_t repeats){
+  return cPiCode::pulseTrainToBuffer(pulses, length, repeats, buffer, size);
+}
+
 /* Encode protocol and json parameters to array of pulses if success */
 int PiCode::encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, const char* json_data){
   return cPiCode::encodeToPulseTrain(pulses, maxlength, protocol, json_data);
@@ -59,11 +82,26 @@ int PiCode::stringToPulseTrain(const char* data, uint32_t* pulses, uint16_t maxl
   return cPiCode::stringToPulseTrain(data, pulses, maxlength);
 }
 
+/* Convert from pilight string of size chars, not null terminated required, to array of pulses if success */
+int PiCode::bufferToPulseTrain(const char* data, size_t size, uint32_t* pulses, uint16_t maxlength, uint8_t* repeats){
+  return cPiCode::bufferToPulseTrain(data, size, pulses, maxlength, repeats);
+}
+
 /* Decode from array of pulses to json as dynamic char*. Must be free() after use */
 char* PiCode::decodePulseTrain(const uint32_t* pulses, uint16_t length, const char* indent){
   return cPiCode::decodePulseTrain(pulses, length, indent);
 }
 
+/* Decode from array of pulses to typed result stored in buffer, no json is built */
+int PiCode::decodePulseTrain(const uint32_t* pulses, uint16_t length, picode_result_t* result, void* buffer, size_t size){
+  return cPiCode::decodePulseTrainResult(pulses, length, result, buffer, size);
+}
+
+/* Convert typed result to json as dynamic char*. Must be free() after use */
+char* PiCode::resultToJson(const picode_result_t* result, const char* indent){
+  return cPiCode::resultToJson(result, indent);
+}
+
 /* Decode from pilight string. Must be free() after use */
 char* PiCode::decodeString(const char* pilight_string){
   return cPiCode::decodeString(pilight_string);
@@ -83,3 +121,23 @@ char* PiCode::encodeJson(const char* json, uint8_t repeats){
 char* PiCode::getPiCodeVersion(){
   return cPiCode::getPiCodeVersion();
 }
+
+/* Decode from array of pulses to json. Result is owned by context, valid until next call */
+const char* PiCode::decodePulseTrain(picode_ctx_t* ctx, const uint32_t* pulses, uint16_t length, const char* indent){
+  return cPiCode::picode_decode_ctx(ctx, pulses, length, indent);
+}
+
+/* Decode from pilight string using context pulse buffer. Result is owned by context, NULL if no match */
+const char* PiCode::decodeString(picode_ctx_t* ctx, const char* pilight_string){
+  return cPiCode::picode_decode_string_ctx(ctx, pilight_string);
+}
+
+/* Encode to pilight string using context pulse buffer. Result is owned by context, valid until next call */
+const char* PiCode::encodeToString(picode_ctx_t* ctx, const char* protocol_name, const char* json_data, uint8_t repeats){
+  return cPiCode::picode_encode_string_ctx(ctx, protocol_name, json_data, repeats);
+}
+
+/* Decode array of items in input order using pool, or calling thread if NULL pool */
+int PiCode::decodeBatch(picode_batch_item_t* items, size_t count, picode_pool_t* pool){
+  return cPiCode::decodeBatch(pool, items, count);
+}
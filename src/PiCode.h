@@ -19,6 +19,7 @@
 #define PICODE_H
 
 #include <cinttypes>         /* uint8_t, etc.            */
+#include <cstddef>           /* size_t                   */
 
 namespace cPiCode {
     extern "C" {
@@ -29,6 +30,22 @@ namespace cPiCode {
 typedef cPiCode::protocol_t         protocol_t;
 typedef cPiCode::protocols_t        protocols_t;
 typedef cPiCode::protocol_devices_t protocol_devices_t;
+typedef cPiCode::picode_ctx_t       picode_ctx_t;
+typedef cPiCode::picode_field_t     picode_field_t;
+typedef cPiCode::picode_match_t     picode_match_t;
+typedef cPiCode::picode_result_t    picode_result_t;
+typedef cPiCode::picode_batch_item_t picode_batch_item_t;
+typedef cPiCode::picode_pool_t      picode_pool_t;
+typedef cPiCode::picode_segmenter_t picode_segmenter_t;
+typedef cPiCode::picode_frame_cb    picode_frame_cb;
+typedef cPiCode::picode_samples_cb  picode_samples_cb;
+typedef cPiCode::picode_ingest_t    picode_ingest_t;
+typedef cPiCode::picode_cache_t     picode_cache_t;
+typedef cPiCode::picode_encode_cache_t picode_encode_cache_t;
+typedef cPiCode::picode_prepared_t  picode_prepared_t;
+typedef cPiCode::protocol_stats_t   protocol_stats_t;
+typedef cPiCode::protocol_stats_entry_t protocol_stats_entry_t;
+typedef cPiCode::protocol_filter_t  protocol_filter_t;
 
 /* Class PiCode                                                              */
 /* ------------------------------------------------------------------------- */
@@ -38,24 +55,51 @@ class PiCode {
   /* Constructor */
   PiCode();
 
-  /* Find protocol by name */
+  /* Find protocol by name, protocol id or device alias like "kaku_switch" */
   protocol_t* findProtocol(const char* name);
 
   /* Convert pulses and length to pilight string format. Must be free() after use */
   char* pulseTrainToString(const uint32_t* pulses, uint16_t maxlength, uint8_t repeats = 0 );
 
+  /* Convert pulses and length to pilight string format in buffer of PULSETRAIN_STRING_SIZE(length).
+     Returns string length if success, or negative error code */
+  int pulseTrainToBuffer(const uint32_t* pulses, uint16_t length, char* buffer, size_t size, uint8_t repeats = 0);
+
   /* Encode protocol and json data to array of pulses if success */
   int encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, const char* json_data);
 
   /* Encode from protocol name and json data to array of pulses if success */
   int encodeToPulseTrainByName(uint32_t* pulses, uint16_t maxlength, const char* protocol_name, const char* json_data);
 
+  /* Encode protocol and typed parameters to array of pulses if success, no json is parsed */
+  int encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, const picode_field_t* fields, uint16_t n_fields){return cPiCode::encodeToPulseTrainFields(pulses, maxlength, protocol, fields, n_fields);}
+
+  /* Encode from protocol name and typed parameters to array of pulses if success, no json is parsed */
+  int encodeToPulseTrainByName(uint32_t* pulses, uint16_t maxlength, const char* protocol_name, const picode_field_t* fields, uint16_t n_fields){return cPiCode::encodeToPulseTrainFieldsByName(pulses, maxlength, protocol_name, fields, n_fields);}
+
   /* Convert from pilight string to array of pulses if success */
   int stringToPulseTrain(const char* data, uint32_t* pulses, uint16_t maxlength);
 
+  /* Convert from pilight string of size chars, not null terminated required, to array of pulses if success */
+  int bufferToPulseTrain(const char* data, size_t size, uint32_t* pulses, uint16_t maxlength, uint8_t* repeats = nullptr);
+
   /* Decode from array of pulses to json as dynamic char*. Must be free() after use */
   char* decodePulseTrain(const uint32_t* pulses, uint16_t length, const char* indent = "   ");
 
+  /* Decode from array of pulses to typed result stored in buffer, no json is built.
+     Returns number of matches, or ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE */
+  int decodePulseTrain(const uint32_t* pulses, uint16_t length, picode_result_t* result, void* buffer, size_t size);
+
+  /* Decode from array of pulses to json using a PICODE_DECODE_* mode. Must be free() after use */
+  char* decodePulseTrainMode(const uint32_t* pulses, uint16_t length, uint8_t mode, const char* indent = "   "){return cPiCode::decodePulseTrainMode(pulses, length, mode, indent);}
+
+  /* Decode from array of pulses to typed result stored in buffer, using a PICODE_DECODE_* mode.
+     Returns number of matches, or ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE */
+  int decodePulseTrainMode(const uint32_t* pulses, uint16_t length, uint8_t mode, picode_result_t* result, void* buffer, size_t size){return cPiCode::decodePulseTrainResultMode(pulses, length, mode, result, buffer, size);}
+
+  /* Convert typed result to json as dynamic char*. Must be free() after use */
+  char* resultToJson(const picode_result_t* result, const char* indent = "   ");
+
   /* Decode from pilight string. Must be free() after use */
   char* decodeString(const char* pilight_string);
 
@@ -68,12 +112,180 @@ class PiCode {
   /* Get PiCode libray version. Must be free() after use */
   char* getPiCodeVersion();
 
-  /* Getter for protocols_t* used_protocols */
-  protocols_t* usedProtocols(){return cPiCode::pilight_protocols;}
+  /* Getter for protocols_t* used_protocols of calling thread */
+  protocols_t* usedProtocols(){return cPiCode::usedProtocols();}
+
+  /* Initialize protocols of calling thread now instead of on first use, returns number of protocols */
+  int init(){return cPiCode::picode_init();}
+
+  /* Release all library memory of calling thread, next call initializes protocols again */
+  void shutdown(){cPiCode::picode_shutdown();}
 
   /* Getter for max possible number of pulses from protocol.h */
   uint16_t protocol_maxrawlen(){return cPiCode::protocol_maxrawlen();}
 
+  /* Create a decode/encode context. Must be freeContext() after use */
+  picode_ctx_t* newContext(){return cPiCode::picode_ctx_new();}
+
+  /* Free context created by newContext() */
+  void freeContext(picode_ctx_t* ctx){cPiCode::picode_ctx_free(ctx);}
+
+  /* Decode from array of pulses to json. Result is owned by context, valid until next call */
+  const char* decodePulseTrain(picode_ctx_t* ctx, const uint32_t* pulses, uint16_t length, const char* indent = "   ");
+
+  /* Decode from pilight string using context pulse buffer. Result is owned by context, NULL if no match */
+  const char* decodeString(picode_ctx_t* ctx, const char* pilight_string);
+
+  /* Encode to pilight string using context pulse buffer. Result is owned by context, valid until next call */
+  const char* encodeToString(picode_ctx_t* ctx, const char* protocol_name, const char* json_data, uint8_t repeats = 0);
+
+  /* Create a worker pool of threads, 0 for one per processor. Must be freePool() after use */
+  picode_pool_t* newPool(unsigned int threads = 0){return cPiCode::picode_pool_new(threads);}
+
+  /* Stop worker threads and free pool created by newPool() */
+  void freePool(picode_pool_t* pool){cPiCode::picode_pool_free(pool);}
+
+  /* Decode array of items in input order using pool, or calling thread if NULL pool.
+     Returns number of matched items, or -1 on failure */
+  int decodeBatch(picode_batch_item_t* items, size_t count, picode_pool_t* pool = nullptr);
+
+  /* Create a frame segmenter for continuous captures, 0 gaplen for shortest protocol gap.
+     Must be freeSegmenter() after use */
+  picode_segmenter_t* newSegmenter(picode_frame_cb callback, void* userdata = nullptr, uint32_t gaplen = 0){return cPiCode::picode_segmenter_new(gaplen, callback, userdata);}
+
+  /* Free segmenter created by newSegmenter(), pending pulses are discarded */
+  void freeSegmenter(picode_segmenter_t* segmenter){cPiCode::picode_segmenter_free(segmenter);}
+
+  /* Feed a chunk of pulse durations, callback is called for each complete frame.
+     Returns number of frames passed to callback */
+  int feedSegmenter(picode_segmenter_t* segmenter, const uint32_t* pulses, size_t count){return cPiCode::picode_segmenter_feed(segmenter, pulses, count);}
+
+  /* Create a LRU decode cache of entries pulse trains, results json with indent. Must be freeCache() after use */
+  picode_cache_t* newCache(uint16_t entries, const char* indent = "   "){return cPiCode::picode_cache_new(entries, indent);}
+
+  /* Free cache created by newCache() */
+  void freeCache(picode_cache_t* cache){cPiCode::picode_cache_free(cache);}
+
+  /* Decode from array of pulses to json using cache. Result is owned by cache, valid until next call */
+  const char* decodePulseTrain(picode_cache_t* cache, const uint32_t* pulses, uint16_t length){return cPiCode::picode_cache_decode(cache, pulses, length);}
+
+  /* Get cache hits and misses counters */
+  void cacheStats(const picode_cache_t* cache, uint64_t* hits, uint64_t* misses){cPiCode::picode_cache_stats(cache, hits, misses);}
+
+  /* Create a LRU encode cache of entries commands. Must be freeCache() after use */
+  picode_encode_cache_t* newEncodeCache(uint16_t entries){return cPiCode::picode_encode_cache_new(entries);}
+
+  /* Free encode cache created by newEncodeCache() */
+  void freeCache(picode_encode_cache_t* cache){cPiCode::picode_encode_cache_free(cache);}
+
+  /* Encode to pilight string using cache. Result is owned by cache, valid until next call */
+  const char* encodeToString(picode_encode_cache_t* cache, const char* protocol_name, const char* json_data, uint8_t repeats = 0){return cPiCode::picode_encode_cache_string(cache, protocol_name, json_data, repeats);}
+
+  /* Encode to pilight string from typed parameters using cache. Result is owned by cache, valid until next call */
+  const char* encodeToString(picode_encode_cache_t* cache, const char* protocol_name, const picode_field_t* fields, uint16_t n_fields, uint8_t repeats = 0){return cPiCode::picode_encode_cache_fields(cache, protocol_name, fields, n_fields, repeats);}
+
+  /* Get pulse train of last encode cache result, returns number of pulses or 0 if failed */
+  uint16_t encodedPulses(const picode_encode_cache_t* cache, const uint32_t** pulses){return cPiCode::picode_encode_cache_pulses(cache, pulses);}
+
+  /* Get encode cache hits and misses counters */
+  void cacheStats(const picode_encode_cache_t* cache, uint64_t* hits, uint64_t* misses){cPiCode::picode_encode_cache_stats(cache, hits, misses);}
+
+  /* Prepare encoder for fixed parameters and defaults of variable parameters. Must be freePrepared() after use */
+  picode_prepared_t* prepare(const char* protocol_name, const picode_field_t* fixed, uint16_t n_fixed, const picode_field_t* variable, uint16_t n_variable){return cPiCode::picode_prepare(protocol_name, fixed, n_fixed, variable, n_variable);}
+
+  /* Free prepared encoder created by prepare() */
+  void freePrepared(picode_prepared_t* prepared){cPiCode::picode_prepared_free(prepared);}
+
+  /* Encode prepared command with values of variable parameters to array of pulses if success */
+  int encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, picode_prepared_t* prepared, const picode_field_t* variable, uint16_t n_variable){return cPiCode::picode_prepared_encode(prepared, variable, n_variable, pulses, maxlength);}
+
+  /* Get number of commands encoded by patching, and number of full encodes */
+  void preparedStats(const picode_prepared_t* prepared, uint64_t* patched, uint64_t* encoded){cPiCode::picode_prepared_stats(prepared, patched, encoded);}
+
+  /* Synthesize OOK baseband samples of pulse train sent frames times to callback, returns number of samples or negative error code */
+  int64_t synthesize(const uint32_t* pulses, uint16_t length, uint16_t frames, uint32_t gap, uint32_t sample_rate, uint8_t format, picode_samples_cb callback, void* userdata = nullptr){return cPiCode::picode_synth(pulses, length, frames, gap, sample_rate, format, callback, userdata);}
+
+  /* Synthesize OOK baseband samples of pulse train sent frames times to file descriptor, returns number of samples or negative error code */
+  int64_t synthesize(const uint32_t* pulses, uint16_t length, uint16_t frames, uint32_t gap, uint32_t sample_rate, uint8_t format, int fd){return cPiCode::picode_synth_fd(pulses, length, frames, gap, sample_rate, format, fd);}
+
+  /* Encode and synthesize OOK baseband samples sent protocol txrpt times to callback, returns number of samples or negative error code */
+  int64_t synthesize(const char* protocol_name, const char* json_data, uint32_t gap, uint32_t sample_rate, uint8_t format, picode_samples_cb callback, void* userdata = nullptr){return cPiCode::picode_synth_encode(protocol_name, json_data, gap, sample_rate, format, callback, userdata);}
+
+  /* Create a sample ingest slicing samples at sample_rate to pulses, callback is called for each frame.
+     Must be freeIngest() after use */
+  picode_ingest_t* newIngest(uint32_t sample_rate, uint8_t format, picode_frame_cb callback, void* userdata = nullptr){return cPiCode::picode_ingest_new(sample_rate, format, callback, userdata);}
+
+  /* Free sample ingest created by newIngest(), pending pulses are discarded */
+  void freeIngest(picode_ingest_t* ingest){cPiCode::picode_ingest_free(ingest);}
+
+  /* Feed a chunk of size bytes of samples, returns number of frames passed to callback */
+  int feedIngest(picode_ingest_t* ingest, const void* samples, size_t size){return cPiCode::picode_ingest_feed(ingest, samples, size);}
+
+  /* End of stream, returns number of frames passed to callback */
+  int finishIngest(picode_ingest_t* ingest){return cPiCode::picode_ingest_finish(ingest);}
+
+  /* Feed all samples read from file descriptor, returns number of frames passed to callback or -1 on read error */
+  int64_t feedIngest(picode_ingest_t* ingest, int fd){return cPiCode::picode_ingest_fd(ingest, fd);}
+
+  /* Enable or disable decode instrumentation counters of calling thread protocols */
+  void enableStats(bool enable = true){cPiCode::protocol_stats_enable(enable ? 1 : 0);}
+
+  /* Reset decode instrumentation counters of calling thread protocols */
+  void resetStats(){cPiCode::protocol_stats_reset();}
+
+  /* Copy counters of up to max protocols, returns number of protocols copied */
+  uint16_t statsSnapshot(protocol_stats_entry_t* entries, uint16_t max){return cPiCode::protocol_stats_snapshot(entries, max);}
+
+  /* Text table of decode instrumentation counters. Must be free() after use */
+  char* dumpStats(){return cPiCode::protocol_stats_dump();}
+
+  /* Add protocols to filter by protocol id or device alias, returns number of protocols added */
+  int filterAdd(protocol_filter_t* filter, const char* name){return cPiCode::protocol_filter_add(filter, name);}
+
+  /* Add protocols to filter by device type, returns number of protocols added */
+  int filterAdd(protocol_filter_t* filter, cPiCode::devtype_t devtype){return cPiCode::protocol_filter_add_devtype(filter, devtype);}
+
+  /* Add protocols to filter by hardware type, returns number of protocols added */
+  int filterAdd(protocol_filter_t* filter, cPiCode::hwtype_t hwtype){return cPiCode::protocol_filter_add_hwtype(filter, hwtype);}
+
+  /* Decode only protocols of filter on calling thread, all protocols if NULL */
+  void setFilter(const protocol_filter_t* filter){cPiCode::protocol_filter_set(filter);}
+
+  /* Decode only protocols of filter on pool workers, all protocols if NULL */
+  void setFilter(picode_pool_t* pool, const protocol_filter_t* filter){cPiCode::picode_pool_filter(pool, filter);}
+
+  /* Packed bits of a word like protocols, bit i is bit (63 - i), first bit received is msb */
+
+  /* Get bit i of word, 0 or 1 */
+  static constexpr int bitsGet(uint64_t word, unsigned int i){return (int)((word >> (63 - i)) & 1);}
+
+  /* Reverse order of the n low bits of value */
+  static constexpr uint64_t bitsReverse(uint64_t value, unsigned int n){return n == 0 ? 0 : ((value & 1) << (n - 1)) | bitsReverse(value >> 1, n - 1);}
+
+  /* Mask of bits s .. e of word, 0<=s<=e<64 */
+  static constexpr uint64_t bitsMask(unsigned int s, unsigned int e){return (e - s >= 63 ? ~(uint64_t)0 : (((uint64_t)1 << (e - s + 1)) - 1)) << (63 - e);}
+
+  /* Value of bits s(msb) .. e(lsb) of word */
+  static constexpr uint64_t bitsToDecRev(uint64_t word, unsigned int s, unsigned int e){return (word << s) >> (63 - (e - s));}
+
+  /* Value of bits s(lsb) .. e(msb) of word */
+  static constexpr uint64_t bitsToDec(uint64_t word, unsigned int s, unsigned int e){return bitsReverse(bitsToDecRev(word, s, e), e - s + 1);}
+
+  /* Two's complement value of the n low bits of value, 0<n<=64 */
+  static constexpr int64_t bitsSignExtend(uint64_t value, unsigned int n){return (int64_t)(n < 64 && ((value >> (n - 1)) & 1) ? value | (~(uint64_t)0 << n) : value);}
+
+  /* Two's complement value of bits s(msb) .. e(lsb) of word, 0<=s<=e<64 */
+  static constexpr int64_t bitsToSignedRev(uint64_t word, unsigned int s, unsigned int e){return bitsSignExtend(bitsToDecRev(word, s, e), e - s + 1);}
+
+  /* Two's complement value of bits s(lsb) .. e(msb) of word, 0<=s<=e<64 */
+  static constexpr int64_t bitsToSigned(uint64_t word, unsigned int s, unsigned int e){return bitsSignExtend(bitsToDec(word, s, e), e - s + 1);}
+
+  /* Word with value stored in bits s(msb) .. e(lsb), other bits are kept */
+  static constexpr uint64_t bitsFromDecRev(uint64_t word, unsigned int s, unsigned int e, uint64_t value){return (word & ~bitsMask(s, e)) | ((value << (63 - e)) & bitsMask(s, e));}
+
+  /* Word with value stored in bits s(lsb) .. e(msb), other bits are kept */
+  static constexpr uint64_t bitsFromDec(uint64_t word, unsigned int s, unsigned int e, uint64_t value){return bitsFromDecRev(word, s, e, bitsReverse(value, e - s + 1));}
+
 };
 
 /* Expose a default object instance */
@@ -19,123 +19,304 @@
 #include <string.h>          /* strcmp(), strcpy(), etc. */
 #include <stdlib.h>          /* malloc(), free(), etc.   */
 #include <inttypes.h>        /* uint8_t, etc.            */
+#include <math.h>            /* fabs()                   */
 
 #include "cPiCode.h"         /* Pure C PiCode library .h */
 
+/* Alignment of matches and fields in typed result buffer */
+#define RESULT_ALIGN          sizeof(double)
+
+/* Stack buffer for typed result used by decodePulseTrain() */
+#define RESULT_BUFFER_SIZE    1024
+
 /* Declared in protocol.h from pilight sources included  */
-extern protocols_t* pilight_protocols;
+extern PROTOCOL_THREAD_LOCAL protocols_t* pilight_protocols;
+
+/* Arena of json trees built by decode and encode calls of each thread */
+static PROTOCOL_THREAD_LOCAL JsonArena* picode_json_arena = NULL;
 
 /* Aux functions                                                             */
 /* ------------------------------------------------------------------------- */
 
-/* Find protocol node */
-static protocols_t* find_protocol_node(const char* name) {
-  if (pilight_protocols==NULL){protocol_init();}
-  protocols_t *pnode = pilight_protocols;
-  while (pnode != NULL) {
-    if (strcmp(name, pnode->listener->id) == 0) {
-      return pnode;
+/* Free json arena of calling thread, also at thread exit */
+static void arena_free(void){
+  if (picode_json_arena != NULL){
+    json_arena_free(picode_json_arena);
+    picode_json_arena = NULL;
+  }
+}
+
+/* Build json trees of calling thread in its arena until arena_end(), returns previous arena */
+static JsonArena* arena_begin(void){
+  if (picode_json_arena == NULL){
+    picode_json_arena = json_arena_new(0);
+    protocol_thread_atexit(arena_free);
+  }
+  return json_arena_use(picode_json_arena);
+}
+
+/* Release json trees built since arena_begin() at once, unless called nested */
+static void arena_end(JsonArena* previous){
+  if (previous != picode_json_arena) json_arena_reset(picode_json_arena);
+  json_arena_use(previous);
+}
+
+/* Reserve aligned bytes from typed result buffer, NULL if not enough */
+static void* result_alloc(picode_result_t* result, size_t size, size_t align){
+  uintptr_t base  = (uintptr_t)result->buffer;
+  size_t    start = (size_t)(((base + result->used + (align - 1)) & ~(uintptr_t)(align - 1)) - base);
+  if (start > result->size || size > result->size - start) return NULL;
+  result->used = start + size;
+  return result->buffer + start;
+}
+
+/* Copy string to typed result buffer, NULL if not enough */
+static const char* result_strdup(picode_result_t* result, const char* str){
+  size_t size = strlen(str) + 1;
+  char*  dup  = (char*)result_alloc(result, size, 1);
+  if (dup != NULL) memcpy(dup, str, size);
+  return dup;
+}
+
+/* Confidence of protocol match from 0 to 1, by distance of footer pulse to the middle of gap length range */
+static double decode_confidence(const protocol_t* protocol, const uint32_t* pulses, uint16_t length){
+
+  double footer = (length > 0) ? (double)pulses[length - 1] : 0;
+  double middle = ((double)protocol->mingaplen + (double)protocol->maxgaplen) / 2;
+  double range  = fabs((double)protocol->maxgaplen - (double)protocol->mingaplen) / 2;
+
+  if (range <= 0) return (footer == middle) ? 1 : 0;
+
+  double confidence = 1 - fabs(footer - middle) / range;
+
+  return (confidence > 0) ? confidence : 0;
+}
+
+/* Protocol validated by a pulse train, and its confidence */
+typedef struct decode_rank_t {
+  protocol_t* protocol;
+  double      confidence;
+} decode_rank_t;
+
+/* Ranked before other: higher confidence, or equal confidence and earlier in registry */
+static int decode_rank_before(const decode_rank_t* rank, const decode_rank_t* other){
+  if (rank->confidence != other->confidence) return rank->confidence > other->confidence;
+  return rank->protocol->index < other->protocol->index;
+}
+
+/* Append protocol message fields as a new match of typed result, 0 if not enough buffer */
+static int result_add_match(picode_result_t* result, picode_match_t** last, protocol_t* protocol, JsonNode* message, double confidence){
+
+  JsonNode       *node     = NULL;
+  uint16_t        n_fields = 0;
+  picode_match_t *match    = (picode_match_t*)result_alloc(result, sizeof(picode_match_t), RESULT_ALIGN);
+
+  if (match == NULL) return 0;
+
+  json_foreach(node, message) {
+    if (node->tag == JSON_NUMBER || node->tag == JSON_STRING) n_fields++;
+  }
+
+  match->protocol   = protocol;
+  match->fields     = NULL;
+  match->n_fields   = 0;
+  match->confidence = confidence;
+  match->next       = NULL;
+
+  if (n_fields > 0) {
+    match->fields = (picode_field_t*)result_alloc(result, n_fields * sizeof(picode_field_t), RESULT_ALIGN);
+    if (match->fields == NULL) return 0;
+  }
+
+  json_foreach(node, message) {
+    picode_field_t* field = &match->fields[match->n_fields];
+    if (node->tag == JSON_NUMBER) {
+      field->type     = PICODE_FIELD_NUMBER;
+      field->decimals = (uint8_t)node->decimals_;
+      field->number   = node->number_;
+      field->string   = NULL;
+    }else if (node->tag == JSON_STRING) {
+      field->type     = PICODE_FIELD_STRING;
+      field->decimals = 0;
+      field->number   = 0;
+      field->string   = result_strdup(result, node->string_);
+      if (field->string == NULL) return 0;
+    }else{
+      continue;
     }
-    pnode = pnode->next;
+    field->key = result_strdup(result, node->key);
+    if (field->key == NULL) return 0;
+    match->n_fields++;
+  }
+
+  if (*last != NULL) {
+    (*last)->next = match;
+  }else{
+    result->matches = match;
   }
-  return NULL;
+  *last = match;
+  result->n_matches++;
+
+  return 1;
+}
+
+/* Append char to buffer at pos, 0 if not enough buffer */
+static int append_char(char* buffer, size_t size, size_t* pos, char ch){
+  if (*pos >= size) return 0;
+  buffer[(*pos)++] = ch;
+  return 1;
 }
 
-/* Search index of char in char* from String class */
-static int indexOf(const char* data, char ch, unsigned int fromIndex) {
-	if (fromIndex >= strlen(data)) return -1;
-	const char* temp = strchr(data + fromIndex, ch);
-	if (temp == NULL) return -1;
-	return (int)(temp - data);
+/* Append decimal number to buffer at pos, 0 if not enough buffer */
+static int append_uint(char* buffer, size_t size, size_t* pos, uint32_t value){
+  char    digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = (char)('0' + (value % 10));
+    value /= 10;
+  } while (value > 0);
+  if (size - *pos < n) return 0;
+  while (n > 0) buffer[(*pos)++] = digits[--n];
+  return 1;
+}
+
+/* Parse decimal number at pos of data, 0 if no digits or greater than max */
+static int parse_uint(const char* data, size_t size, size_t* pos, uint32_t max, uint32_t* value){
+  uint64_t number = 0;
+  size_t   start  = *pos;
+  while (*pos < size && data[*pos] >= '0' && data[*pos] <= '9') {
+    number = number * 10 + (uint64_t)(data[*pos] - '0');
+    if (number > max) return 0;
+    (*pos)++;
+  }
+  *value = (uint32_t)number;
+  return (*pos > start);
 }
 
 /* Library functions                                                         */
 /* ------------------------------------------------------------------------- */
 
-/* Find protocol by name */
+/* Find protocol by name, protocol id or device alias */
 protocol_t* findProtocol(const char* name) {
-  protocols_t *pnode = find_protocol_node(name);
-  if (pnode != NULL) {
-    return pnode->listener;
-  }
-  return NULL;
+  if (name == NULL) return NULL;
+  return protocol_find(name);
 }
 
-/* Convert from array of pulses and length to pilight string format. Must be free() after use */
-char* pulseTrainToString(const uint32_t* pulses, uint16_t maxlength, uint8_t repeats){
-  
-  bool match = false;
-  int  diff  = 0;
+/* Convert from array of pulses and length to pilight string format in buffer. Returns string length if success */
+int pulseTrainToBuffer(const uint32_t* pulses, uint16_t length, uint8_t repeats, char* buffer, size_t size){
+
+  bool   match = false;
+  int    diff  = 0;
+  size_t pos   = 0;
+
+  // Check for length
+  if (length < 2) return ERROR_PULSETRAIN_TOO_SHORT;
 
-  // Check for maxlength
-  if (maxlength < 2) return NULL;
-  
   uint8_t  nrpulses                  =  0 ;  // number of pulse types
   uint32_t plstypes[MAX_PULSE_TYPES] = {0};  // array to store pulse types
 
-  // Aux string to compose data string //
-  char pulse_str[11] = {0};      
+  // Room for "c:", one digit per pulse and ";p:"
+  if (buffer == NULL || size < (size_t)length + 6) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
 
-  // Dynamic string to return. Must be free() after use //
-  // Reserve max memory      "c:             ;   p:      4294967295,            ;  r:31;  @\0"
-  char* data = (char*)malloc( (size_t)(2 + (maxlength) + 1 + 2 + (MAX_PULSE_TYPES*11) + 1 + (5) +  2) );            
-
-  if (!data){
-    return NULL;
-  }else{
-    strcpy(data,"c:");
-  }
+  buffer[pos++] = 'c';
+  buffer[pos++] = ':';
 
-  for (uint16_t i = 0; i < maxlength; i++) {
+  for (uint16_t i = 0; i < length; i++) {
     match = false;
     for (uint8_t j = 0; j < MAX_PULSE_TYPES; j++) {
       // We device these numbers by 10 to normalize them a bit
       diff = (int)((plstypes[j] / 50) - (pulses[i] / 50));
       if ((diff >= -2) && (diff <= 2)) {
-        // Write numbers
-        sprintf(pulse_str,"%c",(char)('0' + ((char)j))); 
-        strcat(data, pulse_str );
+        buffer[pos++] = (char)('0' + j);
         match = true;
         break;
       }
     }
 
     if (!match) {
-      plstypes[nrpulses++] = pulses[i];
-        sprintf(pulse_str,"%c",(char)('0' + ((char)(nrpulses - 1)))); 
-        strcat(data, pulse_str);
-      if (nrpulses > MAX_PULSE_TYPES) {
-        return NULL;
+      if (nrpulses >= MAX_PULSE_TYPES) {
+        return ERROR_TOO_MANY_PULSE_TYPES;
       }
+      plstypes[nrpulses++] = pulses[i];
+      buffer[pos++] = (char)('0' + (nrpulses - 1));
     }
-
   }
 
-  strcat(data, ";p:" );
+  buffer[pos++] = ';';
+  buffer[pos++] = 'p';
+  buffer[pos++] = ':';
 
   for (uint8_t i = 0; i < nrpulses; i++) {
+    if (i > 0 && !append_char(buffer, size, &pos, ',')) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+    if (!append_uint(buffer, size, &pos, plstypes[i])) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+  }
 
-    sprintf(pulse_str, "%d", plstypes[i]); 
-    strcat(data, pulse_str);
-
-    if (i + 1 < nrpulses) {
-      strcat(data, "," );
-    }
+  if (repeats > 0) {
+    if (!append_char(buffer, size, &pos, ';')) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+    if (!append_char(buffer, size, &pos, 'r')) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+    if (!append_char(buffer, size, &pos, ':')) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+    if (!append_uint(buffer, size, &pos, repeats)) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
   }
-  if (repeats > 0 ){
-    strcat(data, ";r:" );
-    sprintf(pulse_str, "%d", repeats); 
-    strcat(data, pulse_str);
 
+  if (!append_char(buffer, size, &pos, '@')) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+
+  // Null terminated, not included in returned length
+  if (pos >= size) return ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE;
+  buffer[pos] = '\0';
+
+  return (int)pos;
+}
+
+/* Convert from array of pulses and length to pilight string format. Must be free() after use */
+char* pulseTrainToString(const uint32_t* pulses, uint16_t maxlength, uint8_t repeats){
+
+  // Check for maxlength
+  if (maxlength < 2) return NULL;
+
+  // Dynamic string to return. Must be free() after use //
+  size_t size = PULSETRAIN_STRING_SIZE(maxlength);
+  char*  data = (char*)malloc(size);
+
+  if (data != NULL && pulseTrainToBuffer(pulses, maxlength, repeats, data, size) < 0) {
+    free(data);
+    data = NULL;
   }
-  strcat(data, "@" );
 
-  // Reduce dynamic memory to only used //
-  data = (char*)realloc(data,strlen(data)+1);
-  
   return data;
 }
 
+/* Encode protocol message to array of pulses if success */
+static int encode_message(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, JsonNode* message){
+
+  int result = ERROR_UNAVAILABLE_PROTOCOL;
+
+  if (protocol != NULL) {
+    if (protocol->createCode != NULL) {      // Check if protocol can encode
+      if (protocol->maxrawlen < maxlength){  // Check if array size is enough
+        protocol->rawlen = 0;
+        protocol->raw = pulses;
+
+        int return_value = protocol->createCode(message);
+
+        // delete message created by createCode()
+        json_delete(protocol->message);
+        protocol->message = NULL;
+
+        if (return_value == EXIT_SUCCESS) {
+          result = protocol->rawlen;
+        } else {
+          result = ERROR_INVALID_PILIGHT_MSG;
+        }
+      }else{
+        result = ERROR_NOT_ENOUGH_PULSES_ARRAY_SIZE;
+      }
+    }else{
+      result = ERROR_PROTOCOL_CANNNOT_ENCODE;
+    }
+  }
+  return result;
+}
+
 /* Encode protocol and json parameters to array of pulses if success */
 int encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, const char* json_data){
 
@@ -158,35 +339,47 @@ int encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, protocol_t* protoco
 
   if (!json_validate(n_json)) {
     result = ERROR_INVALID_JSON;
-  }else{
-    if (protocol != NULL) {
-      if (protocol->createCode != NULL) {      // Check if protocol can encode
-        if (protocol->maxrawlen < maxlength){  // Check if array size is enough
-          protocol->rawlen = 0;
-          protocol->raw = pulses;
+  }else if (protocol != NULL) {
+    JsonArena *previous = arena_begin();
+    JsonNode  *message  = json_decode(n_json);
+    result = encode_message(pulses, maxlength, protocol, message);
+    json_delete(message);
+    arena_end(previous);
+  }
+  free(n_json);
+  return result;
+}
 
-          JsonNode *message = json_decode(n_json);
-          int return_value = protocol->createCode(message);
+/* Encode protocol and typed parameters to array of pulses if success, no json is parsed */
+int encodeToPulseTrainFields(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, const picode_field_t* fields, uint16_t n_fields){
 
-          json_delete(message);
-          // delete message created by createCode()
-          json_delete(protocol->message);
-          protocol->message = NULL;
+  int result = ERROR_UNAVAILABLE_PROTOCOL;
 
-          if (return_value == EXIT_SUCCESS) {
-            result = protocol->rawlen;
-          } else {
-            result = ERROR_INVALID_PILIGHT_MSG;
-          }
-        }else{
-          result = ERROR_NOT_ENOUGH_PULSES_ARRAY_SIZE;
-        }
-      }else{
-        result = ERROR_PROTOCOL_CANNNOT_ENCODE;
-      }
+  if (fields == NULL && n_fields > 0) return ERROR_INVALID_PULSETRAIN_MSG;
+  if (protocol == NULL) return result;
+
+  /* Same message tree json_decode() builds from json parameters */
+  JsonArena *previous = arena_begin();
+  JsonNode  *message  = json_mkobject();
+
+  for (uint16_t i = 0; i < n_fields; i++) {
+    const picode_field_t* field = &fields[i];
+    if (field->key != NULL && field->type == PICODE_FIELD_NUMBER) {
+      json_append_member(message, field->key, json_mknumber(field->number, field->decimals));
+    }else if (field->key != NULL && field->type == PICODE_FIELD_STRING && field->string != NULL) {
+      json_append_member(message, field->key, json_mkstring(field->string));
+    }else{
+      result = ERROR_INVALID_JSON;
+      break;
     }
   }
-  free(n_json);
+
+  if (result != ERROR_INVALID_JSON) {
+    result = encode_message(pulses, maxlength, protocol, message);
+  }
+  json_delete(message);
+  arena_end(previous);
+
   return result;
 }
 
@@ -202,68 +395,102 @@ int encodeToPulseTrainByName(uint32_t* pulses, uint16_t maxlength, const char* p
   return encodeToPulseTrain(pulses, maxlength, protocol, json_data);
 }
 
-/* Convert from pilight string to array of pulses if success */
-int stringToPulseTrain(const char* data, uint32_t* pulses, uint16_t maxlength){
+/* Encode from protocol name and typed parameters to array of pulses if success, no json is parsed */
+int encodeToPulseTrainFieldsByName(uint32_t* pulses, uint16_t maxlength, const char* protocol_name, const picode_field_t* fields, uint16_t n_fields){
+
+  protocol_t* protocol = findProtocol(protocol_name);
+
+  if (protocol == NULL) return ERROR_UNAVAILABLE_PROTOCOL;
+
+  return encodeToPulseTrainFields(pulses, maxlength, protocol, fields, n_fields);
+}
+
+/* Convert from pilight string of size chars, not null terminated required, to array of pulses if success */
+int bufferToPulseTrain(const char* data, size_t size, uint32_t* pulses, uint16_t maxlength, uint8_t* repeats){
 
   int          length                    =  0 ;    // length of pulse train
   uint8_t      nrpulses                  =  0 ;    // number of pulse types
   uint32_t     plstypes[MAX_PULSE_TYPES] = {0};    // array to store pulse types
 
-  // Aux string to compose data string //
-  char pulse_str[6] = {0};   
+  const char*  code    = NULL;   // pulse index section "c:"
+  size_t       ncode   = 0;      // pulse index section size
+  size_t       pos     = 0;
+  uint32_t     value   = 0;
 
-  // validate data string
-  int scode = indexOf(data,'c',0) + 2;
-  if (scode < 2 || (unsigned)scode >  strlen(data)) {
-    // 'c' not found in data string, or has no data
-    return ERROR_INVALID_PULSETRAIN_MSG_C;
-  }
-  int spulse = indexOf(data,'p',0) + 2;
-  if (spulse < 2 || (unsigned)spulse > strlen(data)) {
-    // 'p' not found in data string, or has no data
-    return ERROR_INVALID_PULSETRAIN_MSG_P;
-  }
+  if (repeats != NULL) *repeats = 0;
 
-  // parsing pulse types
-  unsigned int start = (unsigned)spulse;
-  int            end = indexOf(data,',', start);
+  if (data == NULL) return ERROR_INVALID_PULSETRAIN_MSG;
 
-  while (end > 0) {
-    memset(pulse_str,0,sizeof(pulse_str));
-    if ((unsigned)end-start > sizeof(pulse_str)-1) {
-      return -2;
-    }else{
-      strncpy(pulse_str, data+start, (unsigned)end-start);   
-      plstypes[nrpulses++] =  (uint32_t)atol(pulse_str);
+  // Single forward scan of "<key>:<value>" sections separated by ';' up to '@'
+  while (pos < size && data[pos] != '@') {
+
+    // Skip blanks before section key
+    if (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n') {
+      pos++;
+      continue;
     }
-    start = (unsigned)end + 1;
-    end = indexOf(data,',', start);
-  }
 
-  end = indexOf(data,';', start);
-  if (end < 0) {
-    end = indexOf(data,'@', start);
-  }
-  if (end < 0) {
-    // ';' or '@' not found in data string
-    return ERROR_INVALID_PULSETRAIN_MSG_END;
+    char key = data[pos];
+
+    if (pos + 1 >= size || data[pos + 1] != ':') key = '\0';
+    else pos += 2;
+
+    switch (key) {
+      case 'c':
+        // Pulse indexes are checked once pulse types are known
+        code = data + pos;
+        while (pos < size && data[pos] != ';' && data[pos] != '@') pos++;
+        ncode = (size_t)(data + pos - code);
+        break;
+
+      case 'p':
+        // Pulse types comma separated
+        nrpulses = 0;
+        do {
+          while (pos < size && data[pos] == ' ') pos++;
+          if (nrpulses >= MAX_PULSE_TYPES || !parse_uint(data, size, &pos, UINT32_MAX, &value)) {
+            return ERROR_INVALID_PULSETRAIN_MSG_P;
+          }
+          plstypes[nrpulses++] = value;
+        } while (pos < size && data[pos] == ',' && ++pos);
+        if (pos >= size || (data[pos] != ';' && data[pos] != '@')) {
+          // ';' or '@' not found after pulse types
+          return ERROR_INVALID_PULSETRAIN_MSG_END;
+        }
+        break;
+
+      case 'r':
+        if (!parse_uint(data, size, &pos, UINT8_MAX, &value)) {
+          return ERROR_INVALID_PULSETRAIN_MSG_R;
+        }
+        if (pos < size && data[pos] != ';' && data[pos] != '@') {
+          return ERROR_INVALID_PULSETRAIN_MSG_R;
+        }
+        if (repeats != NULL) *repeats = (uint8_t)value;
+        break;
+
+      default:
+        // Skip unknown section
+        while (pos < size && data[pos] != ';' && data[pos] != '@') pos++;
+        break;
+    }
+
+    if (pos < size && data[pos] == ';') pos++;
   }
 
-  memset(pulse_str,0,sizeof(pulse_str));
-  if ((unsigned)end-start > sizeof(pulse_str)-1) {
-    return -3;
-  }else{
-    strncpy(pulse_str, data+start, (unsigned)end-start);
-    plstypes[nrpulses++] =  (uint32_t)atol(pulse_str);
+  if (code == NULL) {
+    // 'c' not found in data string
+    return ERROR_INVALID_PULSETRAIN_MSG_C;
+  }
+  if (nrpulses == 0) {
+    // 'p' not found in data string
+    return ERROR_INVALID_PULSETRAIN_MSG_P;
   }
 
   // parsing pulses
-  int pulse_index = 0;
-  for (unsigned int i = (unsigned)scode; i < strlen(data); i++) {
-    if ((data[i] == ';') || (data[i] == '@')) break;
-    if (i >= maxlength) break;
-    pulse_index = data[i] - '0';
-    if ((pulse_index < 0) || ((unsigned)pulse_index >= nrpulses)) {
+  for (size_t i = 0; i < ncode && length < maxlength; i++) {
+    unsigned int pulse_index = (unsigned int)(code[i] - '0');
+    if (pulse_index >= nrpulses) {
       // Pulse type not defined
       return ERROR_INVALID_PULSETRAIN_MSG_TYPE;
     }
@@ -272,76 +499,184 @@ int stringToPulseTrain(const char* data, uint32_t* pulses, uint16_t maxlength){
   return length;
 }
 
-/* Decode from array of pulses to json as dynamic char*. Must be free() after use */
-char* decodePulseTrain(const uint32_t* pulses, uint16_t length, const char* indent){
-  uint16_t matches = 0;
+/* Convert from pilight string to array of pulses if success */
+int stringToPulseTrain(const char* data, uint32_t* pulses, uint16_t maxlength){
+  if (data == NULL) return ERROR_INVALID_PULSETRAIN_MSG;
+  return bufferToPulseTrain(data, strlen(data), pulses, maxlength, NULL);
+}
 
-  char *result = NULL;
+/* Decode from array of pulses to typed result stored in buffer, using a PICODE_DECODE_* mode */
+int decodePulseTrainResultMode(const uint32_t* pulses, uint16_t length, uint8_t mode, picode_result_t* result, void* buffer, size_t size){
 
-  protocol_t *protocol = NULL;
-  if (pilight_protocols==NULL){protocol_init();}
-  protocols_t *pnode = pilight_protocols;
+  protocol_t       *protocol   = NULL;
+  protocol_t      **candidates = NULL;
+  picode_match_t   *last       = NULL;
+  int               stored     = 1;
+
+  result->matches   = NULL;
+  result->n_matches = 0;
+  result->buffer    = (uint8_t*)buffer;
+  result->size      = (buffer != NULL) ? size : 0;
+  result->used      = 0;
+
+  // Only protocols whose minrawlen/maxrawlen accept this number of pulses
+  uint16_t n_candidates = protocol_candidates(length, &candidates);
+
+  // Messages created by protocols are built in arena
+  JsonArena *previous = arena_begin();
+
+  if (mode == PICODE_DECODE_BEST) {
+
+    decode_rank_t ranked[PROTOCOL_FILTER_WORDS * 64];
+    uint16_t      n_ranked = 0;
+
+    // Validate each candidate once, inserted in rank order
+    for (uint16_t c = 0; c < n_candidates && n_ranked < sizeof(ranked) / sizeof(ranked[0]); c++) {
+      protocol = candidates[c];
+      protocol->raw = (uint32_t*)pulses;
+      protocol->rawlen = length;
+      if (protocol_validate(protocol) == 0) {
+        decode_rank_t rank = { protocol, decode_confidence(protocol, pulses, length) };
+        uint16_t      r    = n_ranked++;
+        while (r > 0 && decode_rank_before(&rank, &ranked[r - 1])) {
+          ranked[r] = ranked[r - 1];
+          r--;
+        }
+        ranked[r] = rank;
+      }
+    }
+
+    // Parse from highest rank until one matches
+    for (uint16_t r = 0; r < n_ranked; r++) {
+      protocol = ranked[r].protocol;
+
+      protocol->raw = (uint32_t*)pulses;
+      protocol->rawlen = length;
+      protocol->message = NULL;
 
-  JsonNode  *output_array = json_mkarray();
+      protocol_parse(protocol);
+
+      if (protocol->message != NULL) {
+        stored = result_add_match(result, &last, protocol, protocol->message, ranked[r].confidence);
+        json_delete(protocol->message);
+        protocol->message = NULL;
+        break;
+      }
+    }
 
-  JsonNode  *protocol_json = NULL;
-  JsonNode  *message_json = NULL;
+  }else{
 
-  while (pnode != NULL) {
-    protocol = pnode->listener;
+    for (uint16_t c = 0; c < n_candidates && stored; c++) {
+      protocol = candidates[c];
 
-    if (protocol->parseCode != NULL && protocol->validate != NULL) {
       protocol->raw = (uint32_t*)pulses;
       protocol->rawlen = length;
 
-      if (protocol->validate() == 0) {
+      if (protocol_validate(protocol) == 0) {
 
         protocol->message = NULL;
 
-        protocol->parseCode();
+        protocol_parse(protocol);
 
         if (protocol->message != NULL) {
 
           // Protocol Match!
-          matches++;
-
-          protocol_json = json_mkobject();
-          message_json  = json_mkobject();
-
-          json_clone(protocol->message, &message_json);
-          
-          json_append_member(protocol_json, protocol->id, message_json );
-          json_append_element(output_array , protocol_json);
+          stored = result_add_match(result, &last, protocol, protocol->message, decode_confidence(protocol, pulses, length));
 
           json_delete(protocol->message);
           protocol->message = NULL;
 
+          if (mode == PICODE_DECODE_FIRST) break;
         }
       }
     }
-    pnode = pnode->next;
   }
-  
-  JsonNode *output_json = json_mkobject();
-  JsonNode *json_array = json_mkobject();
 
-  json_clone(output_array, &json_array);
-  json_append_member(output_json, "protocols", json_array);
+  arena_end(previous);
+
+  if (!stored) return ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE;
+
+  return result->n_matches;
+}
+
+/* Decode from array of pulses to typed result stored in buffer, no json is built */
+int decodePulseTrainResult(const uint32_t* pulses, uint16_t length, picode_result_t* result, void* buffer, size_t size){
+  return decodePulseTrainResultMode(pulses, length, PICODE_DECODE_ALL, result, buffer, size);
+}
+
+/* Convert typed result to json as dynamic char*. Must be free() after use */
+char* resultToJson(const picode_result_t* result, const char* indent){
+
+  char *json = NULL;
+
+  JsonArena *previous = arena_begin();
+
+  JsonNode *output_json  = json_mkobject();
+  JsonNode *output_array = json_mkarray();
+
+  for (const picode_match_t* match = result->matches; match != NULL; match = match->next) {
+
+    JsonNode *protocol_json = json_mkobject();
+    JsonNode *message_json  = json_mkobject();
+
+    for (uint16_t i = 0; i < match->n_fields; i++) {
+      const picode_field_t* field = &match->fields[i];
+      if (field->type == PICODE_FIELD_STRING) {
+        json_append_member(message_json, field->key, json_mkstring(field->string));
+      }else{
+        json_append_member(message_json, field->key, json_mknumber(field->number, field->decimals));
+      }
+    }
+
+    json_append_member(protocol_json, match->protocol->id, message_json);
+    json_append_element(output_array, protocol_json);
+  }
+
+  json_append_member(output_json, "protocols", output_array);
 
   if (strlen(indent)>0){
-    result = json_stringify(output_json, indent);
+    json = json_stringify(output_json, indent);
   }else{
-    result = json_encode(output_json);
+    json = json_encode(output_json);
   }
 
-  for (uint16_t i = 0 ; i<matches; i++){
-    json_delete(json_first_child(output_array));
-  }
-  json_delete(output_array);
-  json_delete(json_array);
   json_delete(output_json);
+  arena_end(previous);
 
-  return result;
+  return json;
+}
+
+/* Decode from array of pulses to json using a PICODE_DECODE_* mode. Must be free() after use */
+char* decodePulseTrainMode(const uint32_t* pulses, uint16_t length, uint8_t mode, const char* indent){
+
+  char            *json   = NULL;
+  uint8_t         *buffer = NULL;
+  picode_result_t  result;
+
+  // Typical results fit in stack, otherwise grow a dynamic buffer
+  uint8_t  stack_buffer[RESULT_BUFFER_SIZE];
+  size_t   size = sizeof(stack_buffer);
+
+  int matches = decodePulseTrainResultMode(pulses, length, mode, &result, stack_buffer, size);
+
+  while (matches == ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE) {
+    free(buffer);
+    size *= 4;
+    buffer = (uint8_t*)malloc(size);
+    if (buffer == NULL) return NULL;
+    matches = decodePulseTrainResultMode(pulses, length, mode, &result, buffer, size);
+  }
+
+  json = resultToJson(&result, indent);
+
+  free(buffer);
+
+  return json;
+}
+
+/* Decode from array of pulses to json as dynamic char*. Must be free() after use */
+char* decodePulseTrain(const uint32_t* pulses, uint16_t length, const char* indent){
+  return decodePulseTrainMode(pulses, length, PICODE_DECODE_ALL, indent);
 }
 
 /* Decode from pilight string. Must be free() after use */
@@ -388,8 +723,8 @@ char* encodeToString(const char* protocol_name, const char* json_data, uint8_t r
   uint32_t*      pulses = NULL;
   int          n_pulses =    0;
 
-  // Max possible number of pulses from protocol.h
-  uint16_t    maxlength = protocol_maxrawlen();
+  // Max possible number of pulses from protocol.h, plus one as encoders require a longer array
+  uint16_t    maxlength = (uint16_t)(protocol_maxrawlen() + 1);
 
   // Dynamic array of pulses
   pulses = (uint32_t*)malloc(sizeof *pulses * (maxlength));
@@ -485,3 +820,120 @@ protocols_t* usedProtocols(void){
   if (pilight_protocols==NULL){protocol_init();}
   return pilight_protocols;
 }
+
+/* Initialize protocols of calling thread now instead of on first use, returns number of protocols */
+int picode_init(void){
+  int n_protocols = 0;
+  protocol_init();
+  for (protocols_t* pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) n_protocols++;
+  return n_protocols;
+}
+
+/* Release all library memory of calling thread: protocols and json arena. Options and device aliases
+   of protocols are shared by all threads and kept.
+   Next call initializes protocols again */
+void picode_shutdown(void){
+  protocol_gc();
+  arena_free();
+}
+
+
+/* Context functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Create a decode/encode context. Must be picode_ctx_free() after use */
+picode_ctx_t* picode_ctx_new(void){
+
+  picode_ctx_t* ctx = (picode_ctx_t*)malloc(sizeof(picode_ctx_t));
+
+  if (ctx != NULL){
+    ctx->maxlength = (uint16_t)(protocol_maxrawlen() + 1);  // Encoders require a longer array than maxrawlen
+    ctx->length    = 0;
+    ctx->result    = NULL;
+    ctx->pulses    = (uint32_t*)calloc(ctx->maxlength, sizeof *ctx->pulses);
+    if (ctx->pulses == NULL){
+      free(ctx);
+      ctx = NULL;
+    }
+  }
+  return ctx;
+}
+
+/* Free context created by picode_ctx_new() */
+void picode_ctx_free(picode_ctx_t* ctx){
+  if (ctx != NULL){
+    free(ctx->result);
+    free(ctx->pulses);
+    free(ctx);
+  }
+}
+
+/* Set context result, freeing the previous one */
+static const char* ctx_set_result(picode_ctx_t* ctx, char* result){
+  free(ctx->result);
+  ctx->result = result;
+  return result;
+}
+
+/* Decode from array of pulses to json. Result is owned by context, valid until next call */
+const char* picode_decode_ctx(picode_ctx_t* ctx, const uint32_t* pulses, uint16_t length, const char* indent){
+  if (ctx == NULL || pulses == NULL) return NULL;
+  return ctx_set_result(ctx, decodePulseTrain(pulses, length, indent));
+}
+
+/* Decode from pilight string using context pulse buffer. Result is owned by context, NULL if no match */
+const char* picode_decode_string_ctx(picode_ctx_t* ctx, const char* pilight_string){
+
+  char* result   = NULL;
+  int   n_pulses = 0;
+
+  if (ctx == NULL) return NULL;
+
+  ctx->length = 0;
+
+  if (pilight_string != NULL){
+    n_pulses = stringToPulseTrain(pilight_string, ctx->pulses, ctx->maxlength);
+    if (n_pulses > 0){
+      ctx->length = (uint16_t)n_pulses;
+      result = decodePulseTrain(ctx->pulses, ctx->length, "   ");
+      if (result != NULL){
+        if (strlen(result) < 23){ // new emply json { "protocols": [] }
+          free(result);
+          result = NULL;
+        }
+      }
+    }
+  }
+  return ctx_set_result(ctx, result);
+}
+
+/* Encode from protocol name and json data to context pulse buffer, returns number of pulses if success */
+int picode_encode_ctx(picode_ctx_t* ctx, const char* protocol_name, const char* json_data){
+
+  int n_pulses = ERROR_UNAVAILABLE_PROTOCOL;
+
+  if (ctx == NULL) return ERROR_NOT_ENOUGH_PULSES_ARRAY_SIZE;
+
+  ctx->length = 0;
+
+  if (protocol_name != NULL){
+    n_pulses = encodeToPulseTrainByName(ctx->pulses, ctx->maxlength, protocol_name, json_data);
+    if (n_pulses > 0){
+      ctx->length = (uint16_t)n_pulses;
+    }
+  }
+  return n_pulses;
+}
+
+/* Encode to pilight string using context pulse buffer. Result is owned by context, valid until next call */
+const char* picode_encode_string_ctx(picode_ctx_t* ctx, const char* protocol_name, const char* json_data, uint8_t repeats){
+
+  char* result = NULL;
+
+  if (ctx == NULL) return NULL;
+
+  if (json_data != NULL && picode_encode_ctx(ctx, protocol_name, json_data) > 0){
+    result = pulseTrainToString(ctx->pulses, ctx->length, repeats);
+  }
+  return ctx_set_result(ctx, result);
+}
@@ -19,6 +19,7 @@
 #define CPICODE_H
 
 #include <inttypes.h>        /* uint8_t, etc.            */
+#include <stddef.h>          /* size_t                   */
 
 #define STRINGIFY2(X) #X
 #define STRINGIFY(X) STRINGIFY2(X)
@@ -61,7 +62,7 @@
 #define ERROR_PROTOCOL_CANNNOT_ENCODE          -4
 #define ERROR_NOT_ENOUGH_PULSES_ARRAY_SIZE     -5
 
-/* Error return codes for stringToPulseTrain() */
+/* Error return codes for stringToPulseTrain() and bufferToPulseTrain() */
 #define ERROR_INVALID_PULSETRAIN_MSG_C         -1
 #define ERROR_INVALID_PULSETRAIN_MSG_P         -2
 #define ERROR_INVALID_PULSETRAIN_MSG_END       -3
@@ -69,9 +70,124 @@
 #define ERROR_INVALID_PULSETRAIN_MSG_R         -5
 #define ERROR_INVALID_PULSETRAIN_MSG           -6
 
-/* Find protocol by name */
+/* Error return codes for pulseTrainToBuffer() */
+#define ERROR_PULSETRAIN_TOO_SHORT             -1
+#define ERROR_TOO_MANY_PULSE_TYPES             -2
+#define ERROR_NOT_ENOUGH_STRING_BUFFER_SIZE    -3
+
+/* Buffer size enough for pulseTrainToBuffer() of length pulses:
+   "c:" + pulses + ";p:" + pulse types of up to 10 digits and "," + ";r:" + repeats + "@" + '\0' */
+#define PULSETRAIN_STRING_SIZE(length) ((size_t)(2 + (length) + 3 + (MAX_PULSE_TYPES*11) + 3 + 3 + 1 + 1))
+
+/* Error return codes for decodePulseTrainResult() */
+#define ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE    -1
+
+/* Error return codes for picode_synth(), not overlapping encodeToPulseTrain() ones */
+#define ERROR_INVALID_SYNTH_PARAMS            -10
+#define ERROR_SYNTH_OUTPUT                    -11
+#define ERROR_SYNTH_OUT_OF_MEMORY             -12
+
+/* Sample formats of picode_synth() and picode_ingest_new() */
+#define PICODE_SAMPLE_U8                        1  /* Unsigned 8 bit amplitude, 0 or 255 */
+#define PICODE_SAMPLE_CS8                       2  /* Signed 8 bit I/Q pairs             */
+#define PICODE_SAMPLE_CF32                      3  /* 32 bit float I/Q pairs             */
+#define PICODE_SAMPLE_CU8                       4  /* Unsigned 8 bit I/Q pairs, rtl-sdr  */
+#define PICODE_SAMPLE_S16                       5  /* Signed 16 bit amplitude, ingest only */
+
+/* Decode modes */
+#define PICODE_DECODE_ALL                       0  /* All matching protocols            */
+#define PICODE_DECODE_FIRST                     1  /* First matching protocol only      */
+#define PICODE_DECODE_BEST                      2  /* Highest confidence match only     */
+
+/* PICODE_DECODE_BEST validates each candidate protocol once and parses them from highest
+   confidence down until one matches. Confidence only depends on footer pulse, so protocols
+   of equal confidence are tried in registry order, the order of PICODE_DECODE_ALL matches */
+
+/* Field types of decoded fields and encode parameters */
+#define PICODE_FIELD_NUMBER                     1
+#define PICODE_FIELD_STRING                     2
+
+/* Field of a protocol message, like "id", "unit" or "temperature".
+   Decoded fields of typed results, or parameters of encodeToPulseTrainFields() */
+typedef struct picode_field_t {
+  const char*  key;       /* Field name                                     */
+  uint8_t      type;      /* PICODE_FIELD_NUMBER or PICODE_FIELD_STRING     */
+  uint8_t      decimals;  /* Number of decimals to show a number field      */
+  double       number;    /* Value of a number field                        */
+  const char*  string;    /* Value of a string field, NULL if number        */
+} picode_field_t;
+
+/* Protocol match, fields in protocol message order */
+typedef struct picode_match_t {
+  protocol_t*             protocol;
+  picode_field_t*         fields;
+  uint16_t                n_fields;
+  double                  confidence; /* From 0 to 1, see PICODE_DECODE_BEST */
+  struct picode_match_t*  next;
+} picode_match_t;
+
+/* Typed decode result, see decodePulseTrainResult().
+   Matches, fields and strings are stored in a caller provided buffer. */
+typedef struct picode_result_t {
+  picode_match_t*  matches;   /* List of matches, NULL if none              */
+  uint16_t         n_matches;
+  uint8_t*         buffer;    /* Caller buffer                              */
+  size_t           size;      /* Size of caller buffer                      */
+  size_t           used;      /* Bytes of caller buffer used                */
+} picode_result_t;
+
+/* Decode/encode context, see picode_ctx_new().
+   Protocol state is kept per thread, so threads decoding or encoding each
+   with its own context need no locking. A context must not be used by two
+   threads at the same time. */
+typedef struct picode_ctx_t {
+  uint32_t*  pulses;      /* Pulse buffer of protocol_maxrawlen() + 1 size  */
+  uint16_t   maxlength;   /* Size of pulse buffer                           */
+  uint16_t   length;      /* Number of pulses stored by last call           */
+  char*      result;      /* Result of last call, owned by context          */
+} picode_ctx_t;
+
+/* Batch decode item, see decodeBatch().
+   Set pilight_string, or pulses and length when pilight_string is NULL. */
+typedef struct picode_batch_item_t {
+  const char*      pilight_string; /* Pilight string to decode, or NULL       */
+  const uint32_t*  pulses;         /* Pulse train to decode                   */
+  uint16_t         length;         /* Number of pulses                        */
+  char*            result;         /* Decoded json, NULL if no match. Must be free() after use */
+} picode_batch_item_t;
+
+/* Batch decode worker pool, see picode_pool_new() */
+typedef struct picode_pool_t picode_pool_t;
+
+/* Streaming frame segmenter, see picode_segmenter_new() */
+typedef struct picode_segmenter_t picode_segmenter_t;
+
+/* Called by segmenter for each complete frame, pulses valid only during call */
+typedef void (*picode_frame_cb)(const uint32_t* pulses, uint16_t length, void* userdata);
+
+/* Called by synthesizer for each chunk of samples, valid only during call. Non zero return aborts */
+typedef int (*picode_samples_cb)(const void* samples, size_t size, void* userdata);
+
+/* SDR sample ingest, see picode_ingest_new() */
+typedef struct picode_ingest_t picode_ingest_t;
+
+/* Decode cache, see picode_cache_new() */
+typedef struct picode_cache_t picode_cache_t;
+
+/* Encode cache, see picode_encode_cache_new() */
+typedef struct picode_encode_cache_t picode_encode_cache_t;
+
+/* Prepared encoder, see picode_prepare().
+   Like contexts, a prepared encoder must not be used by two threads at the same time. */
+typedef struct picode_prepared_t picode_prepared_t;
+
+/* Find protocol by name, protocol id or device alias like "kaku_switch" */
 protocol_t* findProtocol(const char* name);
 
+/* Convert pulses and length to pilight string format in buffer of PULSETRAIN_STRING_SIZE(length).
+   Returns string length if success, or negative error code */
+int pulseTrainToBuffer(const uint32_t* pulses, uint16_t length, uint8_t repeats, char* buffer, size_t size);
+
 /* Convert pulses and length to pilight string format. Must be free() after use */
 char* pulseTrainToString(const uint32_t* pulses, uint16_t maxlength, uint8_t repeats);
 
@@ -81,12 +197,38 @@ int encodeToPulseTrain(uint32_t* pulses, uint16_t maxlength, protocol_t* protoco
 /* Encode from protocol name and json data to array of pulses if success */
 int encodeToPulseTrainByName(uint32_t* pulses, uint16_t maxlength, const char* protocol_name, const char* json_data);
 
+/* Encode protocol and typed parameters to array of pulses if success, no json is parsed.
+   Parameters like json data {"id":1,"unit":2,"on":1}, number decimals are not used */
+int encodeToPulseTrainFields(uint32_t* pulses, uint16_t maxlength, protocol_t* protocol, const picode_field_t* fields, uint16_t n_fields);
+
+/* Encode from protocol name and typed parameters to array of pulses if success, no json is parsed */
+int encodeToPulseTrainFieldsByName(uint32_t* pulses, uint16_t maxlength, const char* protocol_name, const picode_field_t* fields, uint16_t n_fields);
+
 /* Convert from pilight string to array of pulses if success */
 int stringToPulseTrain(const char* data, uint32_t* pulses, uint16_t maxlength);
 
+/* Convert from pilight string of size chars, not null terminated required, to array of pulses if success.
+   Stops at '@', so data can be a slice of a larger buffer. Repeats of "r:" section stored if not NULL */
+int bufferToPulseTrain(const char* data, size_t size, uint32_t* pulses, uint16_t maxlength, uint8_t* repeats);
+
 /* Decode from array of pulses to json as dynamic char*. Must be free() after use */
 char* decodePulseTrain(const uint32_t* pulses, uint16_t length, const char* indent);
 
+/* Decode from array of pulses to typed result stored in buffer, no json is built.
+   Returns number of matches, or ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE */
+int decodePulseTrainResult(const uint32_t* pulses, uint16_t length, picode_result_t* result, void* buffer, size_t size);
+
+/* Decode from array of pulses to typed result stored in buffer, using a PICODE_DECODE_* mode.
+   Confidence is how close footer pulse is to the middle of protocol gap length range.
+   Returns number of matches, or ERROR_NOT_ENOUGH_RESULT_BUFFER_SIZE */
+int decodePulseTrainResultMode(const uint32_t* pulses, uint16_t length, uint8_t mode, picode_result_t* result, void* buffer, size_t size);
+
+/* Decode from array of pulses to json using a PICODE_DECODE_* mode. Must be free() after use */
+char* decodePulseTrainMode(const uint32_t* pulses, uint16_t length, uint8_t mode, const char* indent);
+
+/* Convert typed result to json as dynamic char*. Must be free() after use */
+char* resultToJson(const picode_result_t* result, const char* indent);
+
 /* Decode from pilight string. Must be free() after use */
 char* decodeString(const char* pilight_string);
 
@@ -102,4 +244,156 @@ char* getPiCodeVersion(void);
 /* Getter for protocols_t* pilight_protocols */
 protocols_t* usedProtocols(void);
 
+/* Initialize protocols of calling thread now instead of on first use, returns number of protocols.
+   Protocols are kept per thread and initialized once by each thread, on first use or by this call,
+   so threads may start decoding at once with no shared initialization nor locking */
+int picode_init(void);
+
+/* Release all library memory of calling thread: protocols and json arena. Options and device aliases
+   of protocols are shared by all threads and kept.
+   Protocols found before, and contexts, caches, segmenters, etc. using them, must not be used after.
+   Next call initializes protocols again. Done at exit of threads other than main thread as well */
+void picode_shutdown(void);
+
+/* Create a decode/encode context. Must be picode_ctx_free() after use */
+picode_ctx_t* picode_ctx_new(void);
+
+/* Free context created by picode_ctx_new() */
+void picode_ctx_free(picode_ctx_t* ctx);
+
+/* Decode from array of pulses to json. Result is owned by context, valid until next call */
+const char* picode_decode_ctx(picode_ctx_t* ctx, const uint32_t* pulses, uint16_t length, const char* indent);
+
+/* Decode from pilight string using context pulse buffer. Result is owned by context, NULL if no match */
+const char* picode_decode_string_ctx(picode_ctx_t* ctx, const char* pilight_string);
+
+/* Encode from protocol name and json data to context pulse buffer, returns number of pulses if success */
+int picode_encode_ctx(picode_ctx_t* ctx, const char* protocol_name, const char* json_data);
+
+/* Encode to pilight string using context pulse buffer. Result is owned by context, valid until next call */
+const char* picode_encode_string_ctx(picode_ctx_t* ctx, const char* protocol_name, const char* json_data, uint8_t repeats);
+
+/* Create a worker pool of threads, 0 for one per processor. Must be picode_pool_free() after use */
+picode_pool_t* picode_pool_new(unsigned int threads);
+
+/* Stop worker threads and free pool created by picode_pool_new() */
+void picode_pool_free(picode_pool_t* pool);
+
+/* Decode array of items in input order using pool, or calling thread if NULL pool.
+   Returns number of matched items, or -1 on failure with no result in any item */
+int decodeBatch(picode_pool_t* pool, picode_batch_item_t* items, size_t count);
+
+/* Decode only protocols of filter on pool workers, all protocols if NULL.
+   Filter of calling thread, see protocol_filter_set(), applies to decodeBatch() without pool */
+void picode_pool_filter(picode_pool_t* pool, const protocol_filter_t* filter);
+
+/* Create a frame segmenter for continuous captures, 0 gaplen for shortest protocol gap.
+   Must be picode_segmenter_free() after use */
+picode_segmenter_t* picode_segmenter_new(uint32_t gaplen, picode_frame_cb callback, void* userdata);
+
+/* Free segmenter created by picode_segmenter_new(), pending pulses are discarded */
+void picode_segmenter_free(picode_segmenter_t* segmenter);
+
+/* Discard pending pulses, next pulse starts a new frame */
+void picode_segmenter_reset(picode_segmenter_t* segmenter);
+
+/* Get gap length used to end frames */
+uint32_t picode_segmenter_gaplen(const picode_segmenter_t* segmenter);
+
+/* Feed a chunk of pulse durations, callback is called for each complete frame.
+   Returns number of frames passed to callback */
+int picode_segmenter_feed(picode_segmenter_t* segmenter, const uint32_t* pulses, size_t count);
+
+/* Create a LRU decode cache of entries pulse trains, results json with indent.
+   Must be picode_cache_free() after use */
+picode_cache_t* picode_cache_new(uint16_t entries, const char* indent);
+
+/* Free cache created by picode_cache_new() */
+void picode_cache_free(picode_cache_t* cache);
+
+/* Decode from array of pulses to json, from cache if same pulse types train, with footer between same
+   protocol gap range ends, was decoded before. Cache is emptied when protocol filter of thread changes.
+   Result is owned by cache, valid until next call */
+const char* picode_cache_decode(picode_cache_t* cache, const uint32_t* pulses, uint16_t length);
+
+/* Get cache hits and misses counters */
+void picode_cache_stats(const picode_cache_t* cache, uint64_t* hits, uint64_t* misses);
+
+/* Discard all cached results and reset counters */
+void picode_cache_clear(picode_cache_t* cache);
+
+/* Create a LRU encode cache of entries commands, keyed by protocol, normalized parameters and repeats.
+   Commands missing an option the protocol picks at random, like quigg_gt1000 "num", are not cached.
+   Must be picode_encode_cache_free() after use */
+picode_encode_cache_t* picode_encode_cache_new(uint16_t entries);
+
+/* Free cache created by picode_encode_cache_new() */
+void picode_encode_cache_free(picode_encode_cache_t* cache);
+
+/* Encode to pilight string from protocol name and json data, from cache if same command was encoded before.
+   Result is owned by cache, valid until next call */
+const char* picode_encode_cache_string(picode_encode_cache_t* cache, const char* protocol_name, const char* json_data, uint8_t repeats);
+
+/* Encode to pilight string from protocol name and typed parameters, from cache if same command was encoded before.
+   Result is owned by cache, valid until next call */
+const char* picode_encode_cache_fields(picode_encode_cache_t* cache, const char* protocol_name, const picode_field_t* fields, uint16_t n_fields, uint8_t repeats);
+
+/* Get pulse train of last result, returns number of pulses or 0 if last call failed.
+   Pulses are owned by cache, valid until next call */
+uint16_t picode_encode_cache_pulses(const picode_encode_cache_t* cache, const uint32_t** pulses);
+
+/* Get encode cache hits and misses counters */
+void picode_encode_cache_stats(const picode_encode_cache_t* cache, uint64_t* hits, uint64_t* misses);
+
+/* Discard all cached commands and reset counters */
+void picode_encode_cache_clear(picode_encode_cache_t* cache);
+
+/* Prepare encoder of protocol name for fixed parameters, like "id", and defaults of variable parameters,
+   like "unit" and "on". Commands of protocols picking an option at random, like "num" of quigg_gt1000,
+   are fully encoded unless that option is a parameter.
+   Must be picode_prepared_free() after use, NULL if default command cannot be encoded */
+picode_prepared_t* picode_prepare(const char* protocol_name, const picode_field_t* fixed, uint16_t n_fixed, const picode_field_t* variable, uint16_t n_variable);
+
+/* Free prepared encoder created by picode_prepare() */
+void picode_prepared_free(picode_prepared_t* prepared);
+
+/* Encode prepared command with values of variable parameters, in the same order given to picode_prepare(),
+   like "off" in place of default "on". Pulses changed by each value are patched on the default command.
+   Returns number of pulses stored in array of pulses if success, or negative error code like encodeToPulseTrain() */
+int picode_prepared_encode(picode_prepared_t* prepared, const picode_field_t* variable, uint16_t n_variable, uint32_t* pulses, uint16_t maxlength);
+
+/* Get number of commands encoded by patching, and number of full encodes */
+void picode_prepared_stats(const picode_prepared_t* prepared, uint64_t* patched, uint64_t* encoded);
+
+/* Synthesize OOK baseband samples of pulse train sent frames times, with gap microseconds of carrier off after each frame.
+   Samples in PICODE_SAMPLE_* format at sample_rate are passed in chunks to callback, a non zero return aborts.
+   Returns number of samples, or ERROR_INVALID_SYNTH_PARAMS or ERROR_SYNTH_OUTPUT */
+int64_t picode_synth(const uint32_t* pulses, uint16_t length, uint16_t frames, uint32_t gap, uint32_t sample_rate, uint8_t format, picode_samples_cb callback, void* userdata);
+
+/* Synthesize OOK baseband samples of pulse train to file descriptor, like picode_synth() */
+int64_t picode_synth_fd(const uint32_t* pulses, uint16_t length, uint16_t frames, uint32_t gap, uint32_t sample_rate, uint8_t format, int fd);
+
+/* Encode from protocol name and json data, and synthesize it sent protocol txrpt times like picode_synth().
+   Returns number of samples, or encodeToPulseTrain() error code, or ERROR_INVALID_SYNTH_PARAMS or ERROR_SYNTH_OUTPUT,
+   or ERROR_SYNTH_OUT_OF_MEMORY if no encode context can be allocated */
+int64_t picode_synth_encode(const char* protocol_name, const char* json_data, uint32_t gap, uint32_t sample_rate, uint8_t format, picode_samples_cb callback, void* userdata);
+
+/* Create a sample ingest slicing samples in PICODE_SAMPLE_* format at sample_rate to pulses,
+   passed to a frame segmenter calling callback for each frame. Must be picode_ingest_free() after use */
+picode_ingest_t* picode_ingest_new(uint32_t sample_rate, uint8_t format, picode_frame_cb callback, void* userdata);
+
+/* Free sample ingest created by picode_ingest_new(), pending pulses are discarded */
+void picode_ingest_free(picode_ingest_t* ingest);
+
+/* Feed a chunk of size bytes of samples, a sample may be split across chunks.
+   Returns number of frames passed to callback */
+int picode_ingest_feed(picode_ingest_t* ingest, const void* samples, size_t size);
+
+/* End of stream, pending pulses are passed with a footer. Returns number of frames passed to callback */
+int picode_ingest_finish(picode_ingest_t* ingest);
+
+/* Feed all samples read from file descriptor until end of file, and finish stream.
+   Returns number of frames passed to callback, or -1 on read error */
+int64_t picode_ingest_fd(picode_ingest_t* ingest, int fd);
+
 #endif
@@ -0,0 +1,353 @@
+/*
+    PiCode Library
+
+    Batch decode for pure C PiCode library.
+
+    Items are split in contiguous ranges, one per worker thread. A worker
+    decodes its own range from the head and, once empty, steals the upper
+    half of the largest pending range of another worker. Each worker keeps
+    its own decode context, so protocol state and buffers are reused along
+    the batch and across batches of the same pool.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <string.h>          /* strlen()                 */
+#include <stdlib.h>          /* malloc(), free(), etc.   */
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+#include "cPiCodeThreads.h"  /* Portable threads layer   */
+
+/* Pending item range of a worker                                            */
+typedef struct picode_worker_t {
+  picode_mutex_t         lock;      /* Protects head and tail               */
+  size_t                 head;      /* Next item to decode by owner         */
+  size_t                 tail;      /* End of range, lowered by thieves     */
+  unsigned int           index;     /* Worker number                        */
+  struct picode_pool_t*  pool;
+} picode_worker_t;
+
+struct picode_pool_t {
+  unsigned int           n_workers;
+  picode_thread_t*       threads;
+  picode_worker_t*       workers;
+  picode_mutex_t         run;       /* Serializes decodeBatch() calls       */
+  picode_mutex_t         lock;      /* Protects job state below             */
+  picode_cond_t          job_cond;  /* Signals new job or shutdown          */
+  picode_cond_t          done_cond; /* Signals job completion               */
+  picode_batch_item_t*   items;
+  unsigned long          job;       /* Job generation counter               */
+  unsigned int           busy;      /* Workers still running current job    */
+  int                    matches;
+  size_t                 decoded;   /* Items decoded by workers, matched or not */
+  int                    shutdown;
+  protocol_filter_t      filter;    /* Protocols decoded by workers         */
+  int                    filtered;  /* Filter set, otherwise all protocols  */
+  unsigned long          filter_id; /* Filter generation counter            */
+};
+
+/* Aux functions                                                             */
+/* ------------------------------------------------------------------------- */
+
+/* Decode one item, result is moved from context to item. Returns 1 if match */
+static int batch_decode_item(picode_ctx_t* ctx, picode_batch_item_t* item){
+
+  const char* result = NULL;
+
+  item->result = NULL;
+
+  if (item->pilight_string != NULL){
+    result = picode_decode_string_ctx(ctx, item->pilight_string);
+  }else if (item->pulses != NULL && item->length > 0){
+    result = picode_decode_ctx(ctx, item->pulses, item->length, "   ");
+    if (result != NULL && strlen(result) < 23){ // new emply json { "protocols": [] }
+      result = NULL;
+    }
+  }
+  if (result != NULL){
+    item->result = ctx->result;
+    ctx->result  = NULL;
+    return 1;
+  }
+  return 0;
+}
+
+/* Take next item index from own range, or steal from other workers */
+static int batch_next_item(picode_worker_t* self, size_t* index){
+
+  picode_pool_t*   pool   = self->pool;
+  picode_worker_t* victim = NULL;
+  size_t           pending = 0;
+  size_t           stolen  = 0;
+  size_t           start   = 0;
+  unsigned int     i;
+
+  picode_mutex_lock(&self->lock);
+  if (self->head < self->tail){
+    *index = self->head++;
+    picode_mutex_unlock(&self->lock);
+    return 1;
+  }
+  picode_mutex_unlock(&self->lock);
+
+  /* Find the worker with most pending items */
+  for (i = 1; i < pool->n_workers; i++){
+    picode_worker_t* worker = &pool->workers[(self->index + i) % pool->n_workers];
+    picode_mutex_lock(&worker->lock);
+    if (worker->tail - worker->head > pending){
+      pending = worker->tail - worker->head;
+      victim  = worker;
+    }
+    picode_mutex_unlock(&worker->lock);
+  }
+  if (victim == NULL) return 0;
+
+  /* Steal upper half of its range, it may have changed meanwhile */
+  picode_mutex_lock(&victim->lock);
+  pending = victim->tail - victim->head;
+  if (pending > 0){
+    stolen = (pending + 1) / 2;
+    victim->tail -= stolen;
+    start = victim->tail;
+  }
+  picode_mutex_unlock(&victim->lock);
+
+  if (stolen == 0) return batch_next_item(self, index);
+
+  picode_mutex_lock(&self->lock);
+  self->head = start;
+  self->tail = start + stolen;
+  *index = self->head++;
+  picode_mutex_unlock(&self->lock);
+
+  return 1;
+}
+
+/* Worker thread: wait for jobs until pool shutdown */
+static PICODE_THREAD_ROUTINE(batch_worker, arg){
+
+  picode_worker_t* self = (picode_worker_t*)arg;
+  picode_pool_t*   pool = self->pool;
+  picode_ctx_t*    ctx  = NULL;
+  unsigned long    seen = 0;
+  unsigned long    filter_id = 0;
+  size_t           index;
+  size_t           decoded;
+  int              matches;
+
+  picode_mutex_lock(&pool->lock);
+  for (;;){
+    while (!pool->shutdown && pool->job == seen){
+      picode_cond_wait(&pool->job_cond, &pool->lock);
+    }
+    if (pool->shutdown) break;
+    seen = pool->job;
+    // Apply filter changes to this worker protocols
+    if (filter_id != pool->filter_id){
+      filter_id = pool->filter_id;
+      protocol_filter_set(pool->filtered ? &pool->filter : NULL);
+    }
+    picode_mutex_unlock(&pool->lock);
+
+    // Without context, items are left to other workers
+    if (ctx == NULL) ctx = picode_ctx_new();
+
+    matches = 0;
+    decoded = 0;
+    if (ctx != NULL){
+      while (batch_next_item(self, &index)){
+        matches += batch_decode_item(ctx, &pool->items[index]);
+        decoded++;
+      }
+    }
+
+    picode_mutex_lock(&pool->lock);
+    pool->matches += matches;
+    pool->decoded += decoded;
+    if (--pool->busy == 0){
+      picode_cond_broadcast(&pool->done_cond);
+    }
+  }
+  picode_mutex_unlock(&pool->lock);
+
+  picode_ctx_free(ctx);
+
+  // Release protocols of this worker thread
+  picode_shutdown();
+
+  PICODE_THREAD_RETURN;
+}
+
+/* Decode items on calling thread */
+static int batch_decode_serial(picode_batch_item_t* items, size_t count){
+
+  picode_ctx_t* ctx     = picode_ctx_new();
+  int           matches = 0;
+  size_t        i;
+
+  if (ctx == NULL) return -1;
+
+  for (i = 0; i < count; i++){
+    matches += batch_decode_item(ctx, &items[i]);
+  }
+  picode_ctx_free(ctx);
+
+  return matches;
+}
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Create a worker pool of threads, 0 for one per processor. Must be picode_pool_free() after use */
+picode_pool_t* picode_pool_new(unsigned int threads){
+
+  picode_pool_t* pool = NULL;
+  unsigned int   i;
+
+  if (threads == 0) threads = picode_cpu_count();
+
+  pool = (picode_pool_t*)calloc(1, sizeof(picode_pool_t));
+  if (pool == NULL) return NULL;
+
+  pool->threads = (picode_thread_t*)calloc(threads, sizeof(picode_thread_t));
+  pool->workers = (picode_worker_t*)calloc(threads, sizeof(picode_worker_t));
+  if (pool->threads == NULL || pool->workers == NULL){
+    free(pool->threads);
+    free(pool->workers);
+    free(pool);
+    return NULL;
+  }
+
+  picode_mutex_init(&pool->run);
+  picode_mutex_init(&pool->lock);
+  picode_cond_init(&pool->job_cond);
+  picode_cond_init(&pool->done_cond);
+
+  for (i = 0; i < threads; i++){
+    pool->workers[i].index = i;
+    pool->workers[i].pool  = pool;
+    picode_mutex_init(&pool->workers[i].lock);
+    if (picode_thread_create(&pool->threads[i], batch_worker, &pool->workers[i]) != 0){
+      break;
+    }
+    pool->n_workers++;
+  }
+
+  if (pool->n_workers < threads){
+    picode_mutex_destroy(&pool->workers[pool->n_workers].lock);
+    picode_pool_free(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+/* Stop worker threads and free pool created by picode_pool_new() */
+void picode_pool_free(picode_pool_t* pool){
+
+  unsigned int i;
+
+  if (pool == NULL) return;
+
+  picode_mutex_lock(&pool->lock);
+  pool->shutdown = 1;
+  picode_cond_broadcast(&pool->job_cond);
+  picode_mutex_unlock(&pool->lock);
+
+  for (i = 0; i < pool->n_workers; i++){
+    picode_thread_join(pool->threads[i]);
+    picode_mutex_destroy(&pool->workers[i].lock);
+  }
+
+  picode_cond_destroy(&pool->done_cond);
+  picode_cond_destroy(&pool->job_cond);
+  picode_mutex_destroy(&pool->lock);
+  picode_mutex_destroy(&pool->run);
+
+  free(pool->workers);
+  free(pool->threads);
+  free(pool);
+}
+
+/* Decode only protocols of filter on pool workers, all protocols if NULL */
+void picode_pool_filter(picode_pool_t* pool, const protocol_filter_t* filter){
+
+  if (pool == NULL) return;
+
+  picode_mutex_lock(&pool->run);
+  picode_mutex_lock(&pool->lock);
+  if (filter != NULL){
+    pool->filter   = *filter;
+    pool->filtered = 1;
+  }else{
+    pool->filtered = 0;
+  }
+  pool->filter_id++;
+  picode_mutex_unlock(&pool->lock);
+  picode_mutex_unlock(&pool->run);
+}
+
+/* Decode array of items in input order. Returns number of matched items, or -1 on failure */
+int decodeBatch(picode_pool_t* pool, picode_batch_item_t* items, size_t count){
+
+  size_t       chunk;
+  size_t       decoded;
+  size_t       n;
+  unsigned int i;
+  int          matches;
+
+  if (items == NULL) return -1;
+  if (count == 0) return 0;
+
+  /* Items not decoded on failure have no result */
+  for (n = 0; n < count; n++){
+    items[n].result = NULL;
+  }
+
+  if (pool == NULL){
+    return batch_decode_serial(items, count);
+  }
+
+  picode_mutex_lock(&pool->run);
+
+  /* Split items in contiguous ranges, last worker takes the remainder */
+  chunk = count / pool->n_workers;
+  for (i = 0; i < pool->n_workers; i++){
+    picode_mutex_lock(&pool->workers[i].lock);
+    pool->workers[i].head = i * chunk;
+    pool->workers[i].tail = (i == pool->n_workers - 1) ? count : (i + 1) * chunk;
+    picode_mutex_unlock(&pool->workers[i].lock);
+  }
+
+  picode_mutex_lock(&pool->lock);
+  pool->items   = items;
+  pool->matches = 0;
+  pool->decoded = 0;
+  pool->busy    = pool->n_workers;
+  pool->job++;
+  picode_cond_broadcast(&pool->job_cond);
+  while (pool->busy > 0){
+    picode_cond_wait(&pool->done_cond, &pool->lock);
+  }
+  matches     = pool->matches;
+  decoded     = pool->decoded;
+  pool->items = NULL;
+  picode_mutex_unlock(&pool->lock);
+
+  picode_mutex_unlock(&pool->run);
+
+  /* No worker could create a decode context for some items */
+  if (decoded < count){
+    for (n = 0; n < count; n++){
+      free(items[n].result);
+      items[n].result = NULL;
+    }
+    return -1;
+  }
+
+  return matches;
+}
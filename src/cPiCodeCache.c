@@ -0,0 +1,325 @@
+/*
+    PiCode Library
+
+    Decode cache for pure C PiCode library.
+
+    Remotes repeat each frame many times, so the same train is decoded
+    again and again. Pulse trains are quantized to pulse types, the same
+    way pulseTrainToString() does (pulses within 2*50us of a type are the
+    same type), and the decoded json is kept in a LRU cache keyed by the
+    hash of the type indexes. A hit requires the same type indexes and
+    every pulse type within the same tolerance. As protocols accept a
+    footer by its gap range, not by its type, a hit also requires the
+    footer between the same gap range ends of protocols of that length
+    as the cached one. Pulses other than the footer are only checked by
+    type, so a train near a protocol pulse length limit may be answered
+    as a former train of same types. Results depend on the protocol
+    filter of the thread, so cache is emptied when filter changes.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <string.h>          /* strlen(), memcmp(), etc. */
+#include <stdlib.h>          /* malloc(), free(), etc.   */
+#include <stdbool.h>         /* bool                     */
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+
+#define CACHE_NONE  -1
+
+/* Cached decode of a quantized pulse train */
+typedef struct picode_cache_entry_t {
+  uint32_t   hash;
+  uint16_t   length;                      /* Number of pulses               */
+  uint8_t    nrpulses;                    /* Number of pulse types          */
+  uint32_t   plstypes[MAX_PULSE_TYPES];   /* Pulse types                    */
+  uint8_t*   indexes;                     /* Pulse type of each pulse       */
+  uint32_t   footer_min;                  /* Footer range of same result    */
+  uint32_t   footer_max;
+  char*      result;                      /* Decoded json                   */
+  int32_t    bucket_next;                 /* Next entry of hash bucket      */
+  int32_t    lru_prev;                    /* More recently used entry       */
+  int32_t    lru_next;                    /* Less recently used entry       */
+} picode_cache_entry_t;
+
+struct picode_cache_t {
+  picode_cache_entry_t*  entries;
+  int32_t*               buckets;
+  uint32_t               n_buckets;       /* Power of two                   */
+  uint16_t               capacity;
+  uint16_t               used;
+  uint16_t               maxlength;       /* Longest pulse train cached     */
+  int32_t                lru_head;        /* Most recently used entry       */
+  int32_t                lru_tail;        /* Least recently used entry      */
+  char*                  indent;
+  char*                  uncached;        /* Result of not cacheable train */
+  uint8_t*               indexes;         /* Pulse type of each pulse, key  */
+  uint32_t               filter;          /* Protocol filter generation     */
+  uint64_t               hits;
+  uint64_t               misses;
+};
+
+/* Aux functions                                                             */
+/* ------------------------------------------------------------------------- */
+
+/* Check if pulses are the same type, like pulseTrainToString() */
+static bool same_pulse_type(uint32_t a, uint32_t b){
+  int diff = (int)((a / 50) - (b / 50));
+  return (diff >= -2) && (diff <= 2);
+}
+
+/* Quantize pulse train to pulse type indexes and FNV-1a hash them, false if too many types */
+static bool cache_quantize(picode_cache_t* cache, const uint32_t* pulses, uint16_t length, uint32_t* plstypes, uint8_t* nrpulses, uint32_t* hash){
+
+  uint32_t h = 2166136261u;
+  uint8_t  n = 0;
+  uint8_t  j;
+
+  for (uint16_t i = 0; i < length; i++) {
+    for (j = 0; j < n; j++) {
+      if (same_pulse_type(plstypes[j], pulses[i])) break;
+    }
+    if (j == n) {
+      if (n >= MAX_PULSE_TYPES) return false;
+      plstypes[n++] = pulses[i];
+    }
+    cache->indexes[i] = j;
+    h = (h ^ j) * 16777619u;
+  }
+
+  *nrpulses = n;
+  *hash     = (h ^ length) * 16777619u;
+
+  return true;
+}
+
+/* Footer range around footer without gap range ends of protocols able to decode length pulses,
+   so any footer of that range is accepted or rejected by the same protocols */
+static void cache_footer_range(uint16_t length, uint32_t footer, uint32_t* footer_min, uint32_t* footer_max){
+
+  protocol_t** candidates   = NULL;
+  uint16_t     n_candidates = protocol_candidates(length, &candidates);
+
+  *footer_min = 0;
+  *footer_max = UINT32_MAX;
+
+  for (uint16_t c = 0; c < n_candidates; c++) {
+    uint32_t mingap = candidates[c]->mingaplen;
+    uint32_t maxgap = candidates[c]->maxgaplen;
+    if (maxgap == 0 || maxgap >= UINT32_MAX - 2) continue;
+    if (mingap > maxgap) {
+      mingap = candidates[c]->maxgaplen;
+      maxgap = candidates[c]->mingaplen;
+    }
+    // Range is [mingap, maxgap], so footers change from rejected to accepted at mingap and maxgap + 1.
+    // Ends are truncated from fractional lengths compared by validate(), so true end may be 1us higher
+    uint32_t ends[4] = { mingap, mingap + 1, maxgap + 1, maxgap + 2 };
+    for (int e = 0; e < 4; e++) {
+      if (ends[e] <= footer && ends[e] > *footer_min) *footer_min = ends[e];
+      if (ends[e] >  footer && ends[e] - 1 < *footer_max) *footer_max = ends[e] - 1;
+    }
+  }
+}
+
+/* Discard all cached results */
+static void cache_discard(picode_cache_t* cache){
+  for (uint16_t i = 0; i < cache->used; i++) {
+    free(cache->entries[i].result);
+    cache->entries[i].result = NULL;
+  }
+  for (uint32_t i = 0; i < cache->n_buckets; i++) cache->buckets[i] = CACHE_NONE;
+  cache->used     = 0;
+  cache->lru_head = CACHE_NONE;
+  cache->lru_tail = CACHE_NONE;
+}
+
+/* Unlink entry from LRU list */
+static void lru_unlink(picode_cache_t* cache, int32_t index){
+  picode_cache_entry_t* entry = &cache->entries[index];
+  if (entry->lru_prev != CACHE_NONE) cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+  else cache->lru_head = entry->lru_next;
+  if (entry->lru_next != CACHE_NONE) cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+  else cache->lru_tail = entry->lru_prev;
+}
+
+/* Link entry as most recently used */
+static void lru_push(picode_cache_t* cache, int32_t index){
+  picode_cache_entry_t* entry = &cache->entries[index];
+  entry->lru_prev = CACHE_NONE;
+  entry->lru_next = cache->lru_head;
+  if (cache->lru_head != CACHE_NONE) cache->entries[cache->lru_head].lru_prev = index;
+  cache->lru_head = index;
+  if (cache->lru_tail == CACHE_NONE) cache->lru_tail = index;
+}
+
+/* Unlink entry from its hash bucket */
+static void bucket_unlink(picode_cache_t* cache, int32_t index){
+  int32_t* link = &cache->buckets[cache->entries[index].hash & (cache->n_buckets - 1)];
+  while (*link != index) link = &cache->entries[*link].bucket_next;
+  *link = cache->entries[index].bucket_next;
+}
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Create a decode cache of entries pulse trains, results json with indent. Must be picode_cache_free() after use */
+picode_cache_t* picode_cache_new(uint16_t entries, const char* indent){
+
+  picode_cache_t* cache = NULL;
+
+  if (entries == 0) return NULL;
+  if (indent == NULL) indent = "";
+
+  cache = (picode_cache_t*)calloc(1, sizeof(picode_cache_t));
+  if (cache == NULL) return NULL;
+
+  cache->capacity  = entries;
+  cache->maxlength = protocol_maxrawlen();
+  cache->filter    = protocol_filter_generation();
+  cache->lru_head  = CACHE_NONE;
+  cache->lru_tail  = CACHE_NONE;
+
+  cache->n_buckets = 1;
+  while (cache->n_buckets < 2u * entries) cache->n_buckets <<= 1;
+
+  cache->entries = (picode_cache_entry_t*)calloc(entries, sizeof(picode_cache_entry_t));
+  cache->buckets = (int32_t*)malloc(sizeof *cache->buckets * cache->n_buckets);
+  cache->indexes = (uint8_t*)malloc((size_t)entries * cache->maxlength + cache->maxlength);
+  cache->indent  = (char*)malloc(strlen(indent) + 1);
+
+  if (cache->entries == NULL || cache->buckets == NULL || cache->indexes == NULL || cache->indent == NULL){
+    picode_cache_free(cache);
+    return NULL;
+  }
+
+  strcpy(cache->indent, indent);
+
+  for (uint32_t i = 0; i < cache->n_buckets; i++) cache->buckets[i] = CACHE_NONE;
+
+  // First slot of indexes is the key of current lookup
+  for (uint16_t i = 0; i < entries; i++) {
+    cache->entries[i].indexes = cache->indexes + cache->maxlength * (size_t)(i + 1);
+  }
+
+  return cache;
+}
+
+/* Free cache created by picode_cache_new() */
+void picode_cache_free(picode_cache_t* cache){
+  if (cache != NULL){
+    if (cache->entries != NULL){
+      for (uint16_t i = 0; i < cache->used; i++) free(cache->entries[i].result);
+    }
+    free(cache->entries);
+    free(cache->buckets);
+    free(cache->indexes);
+    free(cache->indent);
+    free(cache->uncached);
+    free(cache);
+  }
+}
+
+/* Decode from array of pulses to json, from cache if a similar train was decoded before.
+   Result is owned by cache, valid until next call */
+const char* picode_cache_decode(picode_cache_t* cache, const uint32_t* pulses, uint16_t length){
+
+  uint32_t  plstypes[MAX_PULSE_TYPES];
+  uint8_t   nrpulses = 0;
+  uint32_t  hash     = 0;
+  int32_t   index    = CACHE_NONE;
+  char*     result   = NULL;
+
+  if (cache == NULL || pulses == NULL) return NULL;
+
+  // Results of a former protocol filter
+  if (cache->filter != protocol_filter_generation()) {
+    cache_discard(cache);
+    cache->filter = protocol_filter_generation();
+  }
+
+  // Not cacheable, too long or too many pulse types
+  if (length > cache->maxlength || !cache_quantize(cache, pulses, length, plstypes, &nrpulses, &hash)) {
+    cache->misses++;
+    free(cache->uncached);
+    cache->uncached = decodePulseTrain(pulses, length, cache->indent);
+    return cache->uncached;
+  }
+
+  // Lookup
+  for (index = cache->buckets[hash & (cache->n_buckets - 1)]; index != CACHE_NONE; index = cache->entries[index].bucket_next) {
+    picode_cache_entry_t* entry = &cache->entries[index];
+    if (entry->hash != hash || entry->length != length || entry->nrpulses != nrpulses) continue;
+    if (length > 0 && (pulses[length - 1] < entry->footer_min || pulses[length - 1] > entry->footer_max)) continue;
+    if (memcmp(entry->indexes, cache->indexes, length) != 0) continue;
+    uint8_t j;
+    for (j = 0; j < nrpulses; j++) {
+      if (!same_pulse_type(entry->plstypes[j], plstypes[j])) break;
+    }
+    if (j == nrpulses) break;
+  }
+
+  if (index != CACHE_NONE) {
+    cache->hits++;
+    lru_unlink(cache, index);
+    lru_push(cache, index);
+    return cache->entries[index].result;
+  }
+
+  cache->misses++;
+
+  result = decodePulseTrain(pulses, length, cache->indent);
+  if (result == NULL) return NULL;
+
+  // Store in a free entry or replace least recently used
+  if (cache->used < cache->capacity) {
+    index = cache->used++;
+  }else{
+    index = cache->lru_tail;
+    lru_unlink(cache, index);
+    bucket_unlink(cache, index);
+    free(cache->entries[index].result);
+  }
+
+  picode_cache_entry_t* entry = &cache->entries[index];
+
+  entry->hash     = hash;
+  entry->length   = length;
+  entry->nrpulses = nrpulses;
+  entry->result   = result;
+  memcpy(entry->plstypes, plstypes, sizeof(plstypes[0]) * nrpulses);
+  memcpy(entry->indexes, cache->indexes, length);
+
+  if (length > 0) {
+    cache_footer_range(length, pulses[length - 1], &entry->footer_min, &entry->footer_max);
+  }else{
+    entry->footer_min = 0;
+    entry->footer_max = UINT32_MAX;
+  }
+
+  entry->bucket_next = cache->buckets[hash & (cache->n_buckets - 1)];
+  cache->buckets[hash & (cache->n_buckets - 1)] = index;
+  lru_push(cache, index);
+
+  return result;
+}
+
+/* Get cache hits and misses counters */
+void picode_cache_stats(const picode_cache_t* cache, uint64_t* hits, uint64_t* misses){
+  if (hits   != NULL) *hits   = (cache != NULL) ? cache->hits   : 0;
+  if (misses != NULL) *misses = (cache != NULL) ? cache->misses : 0;
+}
+
+/* Discard all cached results and reset counters */
+void picode_cache_clear(picode_cache_t* cache){
+  if (cache != NULL){
+    cache_discard(cache);
+    cache->hits     = 0;
+    cache->misses   = 0;
+    free(cache->uncached);
+    cache->uncached = NULL;
+  }
+}
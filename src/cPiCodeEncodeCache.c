@@ -0,0 +1,416 @@
+/*
+    PiCode Library
+
+    Encode cache for pure C PiCode library.
+
+    Scenes and schedules send the same commands again and again, so the
+    encoded pulse train and pilight string of each (protocol, parameters,
+    repeats) are kept in a LRU cache. Parameters are normalized to compact
+    json before hashing: simple ' are taken as double ", and blanks outside
+    strings are dropped. Typed parameters are normalized to the same json,
+    so {'id': 92, 'unit': 0, 'on': 1} and the fields id=92, unit=0, on=1
+    share one entry. Encode failures are not cached, nor commands of
+    protocols which pick an option at random when it is not given, like
+    the sequence number of quigg_gt1000, unless that option is given.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* snprintf()               */
+#include <string.h>          /* strlen(), memcmp(), etc. */
+#include <stdlib.h>          /* malloc(), free(), etc.   */
+#include <stdbool.h>         /* bool                     */
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+
+#define CACHE_NONE      -1
+#define CACHE_UNCACHED  -2     /* Last result is not cached */
+
+/* Cached encode of protocol and parameters */
+typedef struct picode_encode_entry_t {
+  uint32_t   hash;
+  size_t     key_length;
+  char*      key;                         /* Protocol, parameters, repeats  */
+  uint32_t*  pulses;                      /* Encoded pulse train            */
+  uint16_t   length;                      /* Number of pulses               */
+  char*      result;                      /* Pilight string                 */
+  int32_t    bucket_next;                 /* Next entry of hash bucket      */
+  int32_t    lru_prev;                    /* More recently used entry       */
+  int32_t    lru_next;                    /* Less recently used entry       */
+} picode_encode_entry_t;
+
+struct picode_encode_cache_t {
+  picode_encode_entry_t*  entries;
+  int32_t*                buckets;
+  uint32_t                n_buckets;      /* Power of two                   */
+  uint16_t                capacity;
+  uint16_t                used;
+  int32_t                 lru_head;       /* Most recently used entry       */
+  int32_t                 lru_tail;       /* Least recently used entry      */
+  int32_t                 last;           /* Entry of last result           */
+  picode_ctx_t*           ctx;            /* Pulse buffer to encode misses  */
+  char*                   uncached;       /* Result of not cacheable command */
+  uint16_t                uncached_length;
+  char*                   key;            /* Key of current lookup          */
+  size_t                  key_size;
+  size_t                  key_length;
+  uint64_t                hits;
+  uint64_t                misses;
+};
+
+/* Aux functions                                                             */
+/* ------------------------------------------------------------------------- */
+
+/* Make room for size more chars in lookup key, false if out of memory */
+static bool key_reserve(picode_encode_cache_t* cache, size_t size){
+  if (cache->key_length + size > cache->key_size) {
+    size_t new_size = 2 * (cache->key_length + size);
+    char*  key      = (char*)realloc(cache->key, new_size);
+    if (key == NULL) return false;
+    cache->key      = key;
+    cache->key_size = new_size;
+  }
+  return true;
+}
+
+/* Append chars to lookup key, false if out of memory */
+static bool key_append(picode_encode_cache_t* cache, const char* data, size_t size){
+  if (!key_reserve(cache, size)) return false;
+  memcpy(cache->key + cache->key_length, data, size);
+  cache->key_length += size;
+  return true;
+}
+
+/* Append json string of str to lookup key, false if out of memory */
+static bool key_append_string(picode_encode_cache_t* cache, const char* str){
+  if (!key_reserve(cache, 2 * strlen(str) + 2)) return false;
+  cache->key[cache->key_length++] = '"';
+  for (; *str != '\0'; str++) {
+    if (*str == '"' || *str == '\\') cache->key[cache->key_length++] = '\\';
+    cache->key[cache->key_length++] = *str;
+  }
+  cache->key[cache->key_length++] = '"';
+  return true;
+}
+
+/* Start lookup key with protocol name */
+static bool key_begin(picode_encode_cache_t* cache, const char* protocol_name){
+  cache->key_length = 0;
+  return key_append(cache, protocol_name, strlen(protocol_name) + 1);
+}
+
+/* End lookup key with repeats */
+static bool key_end(picode_encode_cache_t* cache, uint8_t repeats){
+  char end[2] = { '\0', (char)repeats };
+  return key_append(cache, end, sizeof(end));
+}
+
+/* Append json parameters to lookup key, ' as " and no blanks outside strings */
+static bool key_json(picode_encode_cache_t* cache, const char* json_data){
+
+  size_t length = strlen(json_data);
+  bool   quoted = false;
+
+  if (!key_reserve(cache, length)) return false;
+
+  for (size_t i = 0; i < length; i++) {
+    char c = (json_data[i] == '\'') ? '"' : json_data[i];
+    if (quoted) {
+      if (c == '\\' && i + 1 < length) {
+        cache->key[cache->key_length++] = c;
+        c = json_data[++i];
+      }else if (c == '"') {
+        quoted = false;
+      }
+    }else if (c == '"') {
+      quoted = true;
+    }else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      continue;
+    }
+    cache->key[cache->key_length++] = c;
+  }
+  return true;
+}
+
+/* Append typed parameters to lookup key as compact json, false if invalid */
+static bool key_fields(picode_encode_cache_t* cache, const picode_field_t* fields, uint16_t n_fields){
+
+  char number[32];
+
+  if (!key_append(cache, "{", 1)) return false;
+
+  for (uint16_t i = 0; i < n_fields; i++) {
+    const picode_field_t* field = &fields[i];
+    if (field->key == NULL) return false;
+    if (i > 0 && !key_append(cache, ",", 1)) return false;
+    if (!key_append_string(cache, field->key) || !key_append(cache, ":", 1)) return false;
+    if (field->type == PICODE_FIELD_NUMBER) {
+      int size = snprintf(number, sizeof(number), "%.17g", field->number);
+      if (size < 0 || !key_append(cache, number, (size_t)size)) return false;
+    }else if (field->type == PICODE_FIELD_STRING && field->string != NULL) {
+      if (!key_append_string(cache, field->string)) return false;
+    }else{
+      return false;
+    }
+  }
+
+  return key_append(cache, "}", 1);
+}
+
+/* FNV-1a hash of lookup key */
+static uint32_t key_hash(const picode_encode_cache_t* cache){
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < cache->key_length; i++) {
+    h = (h ^ (uint8_t)cache->key[i]) * 16777619u;
+  }
+  return h;
+}
+
+/* True if protocol picks an option at random and lookup key parameters do not give it */
+static bool key_random(const picode_encode_cache_t* cache, const char* protocol_name){
+
+  protocol_t* protocol = findProtocol(protocol_name);
+  size_t      start    = strlen(protocol_name) + 1;
+  size_t      size;
+
+  if (protocol == NULL || protocol->randomopt == NULL) return false;
+
+  // Parameters are compact json, so a given option is "<option>":
+  size = strlen(protocol->randomopt);
+  for (size_t i = start; i + size + 3 <= cache->key_length; i++) {
+    if (cache->key[i] == '"' && memcmp(cache->key + i + 1, protocol->randomopt, size) == 0 &&
+        cache->key[i + size + 1] == '"' && cache->key[i + size + 2] == ':') return false;
+  }
+  return true;
+}
+
+/* Unlink entry from LRU list */
+static void lru_unlink(picode_encode_cache_t* cache, int32_t index){
+  picode_encode_entry_t* entry = &cache->entries[index];
+  if (entry->lru_prev != CACHE_NONE) cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+  else cache->lru_head = entry->lru_next;
+  if (entry->lru_next != CACHE_NONE) cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+  else cache->lru_tail = entry->lru_prev;
+}
+
+/* Link entry as most recently used */
+static void lru_push(picode_encode_cache_t* cache, int32_t index){
+  picode_encode_entry_t* entry = &cache->entries[index];
+  entry->lru_prev = CACHE_NONE;
+  entry->lru_next = cache->lru_head;
+  if (cache->lru_head != CACHE_NONE) cache->entries[cache->lru_head].lru_prev = index;
+  cache->lru_head = index;
+  if (cache->lru_tail == CACHE_NONE) cache->lru_tail = index;
+}
+
+/* Unlink entry from its hash bucket */
+static void bucket_unlink(picode_encode_cache_t* cache, int32_t index){
+  int32_t* link = &cache->buckets[cache->entries[index].hash & (cache->n_buckets - 1)];
+  while (*link != index) link = &cache->entries[*link].bucket_next;
+  *link = cache->entries[index].bucket_next;
+}
+
+/* Free entry data */
+static void entry_clear(picode_encode_entry_t* entry){
+  free(entry->key);
+  free(entry->pulses);
+  free(entry->result);
+  entry->key    = NULL;
+  entry->pulses = NULL;
+  entry->result = NULL;
+}
+
+/* Find lookup key in cache, or encode it with message of fields or json data and store it */
+static const char* cache_encode(picode_encode_cache_t* cache, const char* protocol_name, const char* json_data, const picode_field_t* fields, uint16_t n_fields, uint8_t repeats){
+
+  uint32_t  hash  = key_hash(cache);
+  int32_t   index = CACHE_NONE;
+  int       n_pulses;
+
+  cache->last = CACHE_NONE;
+
+  // Lookup
+  for (index = cache->buckets[hash & (cache->n_buckets - 1)]; index != CACHE_NONE; index = cache->entries[index].bucket_next) {
+    picode_encode_entry_t* entry = &cache->entries[index];
+    if (entry->hash == hash && entry->key_length == cache->key_length && memcmp(entry->key, cache->key, cache->key_length) == 0) break;
+  }
+
+  if (index != CACHE_NONE) {
+    cache->hits++;
+    lru_unlink(cache, index);
+    lru_push(cache, index);
+    cache->last = index;
+    return cache->entries[index].result;
+  }
+
+  cache->misses++;
+
+  if (json_data != NULL) {
+    n_pulses = encodeToPulseTrainByName(cache->ctx->pulses, cache->ctx->maxlength, protocol_name, json_data);
+  }else{
+    n_pulses = encodeToPulseTrainFieldsByName(cache->ctx->pulses, cache->ctx->maxlength, protocol_name, fields, n_fields);
+  }
+  if (n_pulses <= 0) return NULL;
+
+  // Not cacheable, another encode may pick another random option
+  if (key_random(cache, protocol_name)) {
+    free(cache->uncached);
+    cache->uncached = pulseTrainToString(cache->ctx->pulses, (uint16_t)n_pulses, repeats);
+    if (cache->uncached == NULL) return NULL;
+    cache->uncached_length = (uint16_t)n_pulses;
+    cache->last = CACHE_UNCACHED;
+    return cache->uncached;
+  }
+
+  char*     result = pulseTrainToString(cache->ctx->pulses, (uint16_t)n_pulses, repeats);
+  uint32_t* pulses = (uint32_t*)malloc(sizeof *pulses * (size_t)n_pulses);
+  char*     key    = (char*)malloc(cache->key_length);
+
+  if (result == NULL || pulses == NULL || key == NULL) {
+    free(result);
+    free(pulses);
+    free(key);
+    return NULL;
+  }
+
+  // Store in a free entry or replace least recently used
+  if (cache->used < cache->capacity) {
+    index = cache->used++;
+  }else{
+    index = cache->lru_tail;
+    lru_unlink(cache, index);
+    bucket_unlink(cache, index);
+    entry_clear(&cache->entries[index]);
+  }
+
+  picode_encode_entry_t* entry = &cache->entries[index];
+
+  entry->hash       = hash;
+  entry->key_length = cache->key_length;
+  entry->key        = key;
+  entry->pulses     = pulses;
+  entry->length     = (uint16_t)n_pulses;
+  entry->result     = result;
+  memcpy(entry->key, cache->key, cache->key_length);
+  memcpy(entry->pulses, cache->ctx->pulses, sizeof *pulses * (size_t)n_pulses);
+
+  entry->bucket_next = cache->buckets[hash & (cache->n_buckets - 1)];
+  cache->buckets[hash & (cache->n_buckets - 1)] = index;
+  lru_push(cache, index);
+  cache->last = index;
+
+  return result;
+}
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Create a LRU encode cache of entries commands. Must be picode_encode_cache_free() after use */
+picode_encode_cache_t* picode_encode_cache_new(uint16_t entries){
+
+  picode_encode_cache_t* cache = NULL;
+
+  if (entries == 0) return NULL;
+
+  cache = (picode_encode_cache_t*)calloc(1, sizeof(picode_encode_cache_t));
+  if (cache == NULL) return NULL;
+
+  cache->capacity = entries;
+  cache->lru_head = CACHE_NONE;
+  cache->lru_tail = CACHE_NONE;
+  cache->last     = CACHE_NONE;
+
+  cache->n_buckets = 1;
+  while (cache->n_buckets < 2u * entries) cache->n_buckets <<= 1;
+
+  cache->entries = (picode_encode_entry_t*)calloc(entries, sizeof(picode_encode_entry_t));
+  cache->buckets = (int32_t*)malloc(sizeof *cache->buckets * cache->n_buckets);
+  cache->ctx     = picode_ctx_new();
+
+  if (cache->entries == NULL || cache->buckets == NULL || cache->ctx == NULL){
+    picode_encode_cache_free(cache);
+    return NULL;
+  }
+
+  for (uint32_t i = 0; i < cache->n_buckets; i++) cache->buckets[i] = CACHE_NONE;
+
+  return cache;
+}
+
+/* Free cache created by picode_encode_cache_new() */
+void picode_encode_cache_free(picode_encode_cache_t* cache){
+  if (cache != NULL){
+    if (cache->entries != NULL){
+      for (uint16_t i = 0; i < cache->used; i++) entry_clear(&cache->entries[i]);
+    }
+    free(cache->entries);
+    free(cache->buckets);
+    free(cache->key);
+    free(cache->uncached);
+    picode_ctx_free(cache->ctx);
+    free(cache);
+  }
+}
+
+/* Encode to pilight string from protocol name and json data, from cache if same command was encoded before.
+   Result is owned by cache, valid until next call */
+const char* picode_encode_cache_string(picode_encode_cache_t* cache, const char* protocol_name, const char* json_data, uint8_t repeats){
+
+  if (cache == NULL || protocol_name == NULL || json_data == NULL) return NULL;
+
+  if (!key_begin(cache, protocol_name) || !key_json(cache, json_data) || !key_end(cache, repeats)) return NULL;
+
+  return cache_encode(cache, protocol_name, json_data, NULL, 0, repeats);
+}
+
+/* Encode to pilight string from protocol name and typed parameters, from cache if same command was encoded before.
+   Result is owned by cache, valid until next call */
+const char* picode_encode_cache_fields(picode_encode_cache_t* cache, const char* protocol_name, const picode_field_t* fields, uint16_t n_fields, uint8_t repeats){
+
+  if (cache == NULL || protocol_name == NULL || (fields == NULL && n_fields > 0)) return NULL;
+
+  if (!key_begin(cache, protocol_name) || !key_fields(cache, fields, n_fields) || !key_end(cache, repeats)) return NULL;
+
+  return cache_encode(cache, protocol_name, NULL, fields, n_fields, repeats);
+}
+
+/* Get pulse train of last result, returns number of pulses or 0 if last call failed.
+   Pulses are owned by cache, valid until next call */
+uint16_t picode_encode_cache_pulses(const picode_encode_cache_t* cache, const uint32_t** pulses){
+  if (cache == NULL || cache->last == CACHE_NONE) {
+    if (pulses != NULL) *pulses = NULL;
+    return 0;
+  }
+  if (cache->last == CACHE_UNCACHED) {
+    if (pulses != NULL) *pulses = cache->ctx->pulses;
+    return cache->uncached_length;
+  }
+  if (pulses != NULL) *pulses = cache->entries[cache->last].pulses;
+  return cache->entries[cache->last].length;
+}
+
+/* Get cache hits and misses counters */
+void picode_encode_cache_stats(const picode_encode_cache_t* cache, uint64_t* hits, uint64_t* misses){
+  if (hits   != NULL) *hits   = (cache != NULL) ? cache->hits   : 0;
+  if (misses != NULL) *misses = (cache != NULL) ? cache->misses : 0;
+}
+
+/* Discard all cached commands and reset counters */
+void picode_encode_cache_clear(picode_encode_cache_t* cache){
+  if (cache != NULL){
+    for (uint16_t i = 0; i < cache->used; i++) entry_clear(&cache->entries[i]);
+    for (uint32_t i = 0; i < cache->n_buckets; i++) cache->buckets[i] = CACHE_NONE;
+    free(cache->uncached);
+    cache->uncached = NULL;
+    cache->used     = 0;
+    cache->lru_head = CACHE_NONE;
+    cache->lru_tail = CACHE_NONE;
+    cache->last     = CACHE_NONE;
+    cache->hits     = 0;
+    cache->misses   = 0;
+  }
+}
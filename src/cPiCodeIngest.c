@@ -0,0 +1,428 @@
+/*
+    PiCode Library
+
+    SDR sample ingest for pure C PiCode library.
+
+    Recorded baseband samples, like rtl-sdr cu8 I/Q files or s16 envelope
+    files, are sliced to pulse durations and passed to a frame segmenter.
+    Envelope is the I/Q magnitude, approximated as max + 3/8 min of the
+    absolute components. Slicing threshold adapts to the signal: it is
+    half way between the noise floor, tracked while carrier is off, and
+    the carrier level, tracked while carrier is on and slowly decaying to
+    the noise floor after each burst. Threshold is never below twice the
+    noise floor, and has a hysteresis of a quarter of the noise margin.
+    Trains start at first carrier on. A carrier off longer than the gap of
+    any protocol of that frame length closes the frame at once, and the rest
+    of the silence is skipped until next carrier on. Frames of a burst are
+    ended by their real gap, which tells apart protocols of the same length.
+    As the real gap of a closed frame is unknown, its footer is the one of
+    previous frame of the burst if it had the same length, else the middle
+    of the gap range of the first protocol of that length decoding it, so
+    last frames of a burst and single frames are decoded as well.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <string.h>          /* memcpy()                 */
+#include <stdlib.h>          /* malloc(), free(), etc.   */
+#include <stdbool.h>         /* bool                     */
+#include <errno.h>           /* errno, EINTR             */
+
+#ifdef _WIN32
+#include <io.h>              /* _read()                  */
+#else
+#include <unistd.h>          /* read()                   */
+#endif
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+
+/* Envelope levels are fixed point with 8 fractional bits */
+#define INGEST_SHIFT          8
+
+/* Lowest noise margin of threshold, about -30 dBFS of envelope full scale 32767 */
+#define INGEST_MIN_MARGIN     (1024 << INGEST_SHIFT)
+
+/* Pulses buffered before passing them to segmenter */
+#define INGEST_PULSES         256
+
+/* Bytes read from file descriptor at once */
+#define INGEST_READ_SIZE      65536
+
+/* Result buffer of footer decode tries */
+#define INGEST_RESULT_SIZE    1024
+
+/* Footers remembered to skip tries inside gap ranges already tried */
+#define INGEST_FOOTER_TRIES   32
+
+struct picode_ingest_t {
+  picode_segmenter_t*  segmenter;
+  uint32_t             sample_rate;
+  uint8_t              format;
+  size_t               sample_size;     /* Bytes of a sample                */
+  uint8_t              partial[8];      /* Bytes of an incomplete sample    */
+  size_t               n_partial;
+  uint32_t             gaplen;          /* Silence closing a frame, us      */
+  uint32_t*            closegaps;       /* Silence closing frame by length  */
+  uint32_t*            frame;           /* Pulses of current frame          */
+  uint16_t             maxlength;       /* Longest frame of any protocol    */
+  uint16_t             n_frame;         /* Pulses of current frame, footer  */
+                                        /* excluded, maxlength+1 if longer  */
+  uint16_t             burst_length;    /* Length of previous burst frame   */
+  uint32_t             burst_footer;    /* Footer of previous burst frame   */
+  int32_t              noise;           /* Noise floor level                */
+  int32_t              carrier;         /* Carrier on level                 */
+  bool                 started;         /* Noise floor initialized          */
+  bool                 on;              /* Carrier on                       */
+  bool                 idle;            /* Silence after footer passed      */
+  uint64_t             sample;          /* Samples from stream start        */
+  uint64_t             edge;            /* Microseconds of last edge        */
+  uint32_t             pulses[INGEST_PULSES];
+  uint16_t             n_pulses;
+  int                  frames;          /* Frames passed by current call    */
+};
+
+/* Aux functions                                                             */
+/* ------------------------------------------------------------------------- */
+
+/* Bytes of a sample of format, 0 if unknown format */
+static size_t ingest_sample_size(uint8_t format){
+  switch (format) {
+    case PICODE_SAMPLE_U8:   return 1;
+    case PICODE_SAMPLE_CS8:  return 2;
+    case PICODE_SAMPLE_CF32: return 2 * sizeof(float);
+    case PICODE_SAMPLE_CU8:  return 2;
+    case PICODE_SAMPLE_S16:  return sizeof(int16_t);
+    default:                 return 0;
+  }
+}
+
+/* Magnitude of I/Q components, max + 3/8 min */
+static int32_t ingest_magnitude(int32_t i, int32_t q){
+  if (i < 0) i = -i;
+  if (q < 0) q = -q;
+  return (i > q) ? i + ((3 * q) >> 3) : q + ((3 * i) >> 3);
+}
+
+/* Envelope of a sample, from 0 to about 32767 */
+static int32_t ingest_envelope(const picode_ingest_t* ingest, const uint8_t* sample){
+  switch (ingest->format) {
+    case PICODE_SAMPLE_U8:
+      return (int32_t)sample[0] << 7;
+    case PICODE_SAMPLE_CS8:
+      return ingest_magnitude((int8_t)sample[0], (int8_t)sample[1]) << 8;
+    case PICODE_SAMPLE_CU8:
+      return ingest_magnitude(2 * (int32_t)sample[0] - 255, 2 * (int32_t)sample[1] - 255) << 7;
+    case PICODE_SAMPLE_S16: {
+      int16_t value;
+      memcpy(&value, sample, sizeof(value));
+      return (value < 0) ? -(int32_t)value : value;
+    }
+    default: {
+      float iq[2];
+      memcpy(iq, sample, sizeof(iq));
+      float i = (iq[0] < 0) ? -iq[0] : iq[0];
+      float q = (iq[1] < 0) ? -iq[1] : iq[1];
+      float m = (i > q) ? i + 0.375f * q : q + 0.375f * i;
+      return (m < 2.0f) ? (int32_t)(m * 32767.0f) : 65534;
+    }
+  }
+}
+
+/* Pass buffered pulses to segmenter */
+static void ingest_flush_pulses(picode_ingest_t* ingest){
+  if (ingest->n_pulses > 0) {
+    ingest->frames += picode_segmenter_feed(ingest->segmenter, ingest->pulses, ingest->n_pulses);
+    ingest->n_pulses = 0;
+  }
+}
+
+/* Add a pulse of duration microseconds, a gap ends current frame */
+static void ingest_pulse(picode_ingest_t* ingest, uint64_t duration){
+  ingest->pulses[ingest->n_pulses++] = (duration < UINT32_MAX) ? (uint32_t)duration : UINT32_MAX;
+  if (duration >= ingest->gaplen) {
+    if (ingest->n_frame > 0) {
+      ingest->burst_length = ingest->n_frame + 1;
+      ingest->burst_footer = ingest->pulses[ingest->n_pulses - 1];
+    }
+    ingest->n_frame = 0;
+  }else if (ingest->n_frame <= ingest->maxlength) {
+    if (ingest->n_frame < ingest->maxlength) ingest->frame[ingest->n_frame] = (uint32_t)duration;
+    ingest->n_frame++;
+  }
+  if (ingest->n_pulses == INGEST_PULSES) ingest_flush_pulses(ingest);
+}
+
+/* Gap range of protocol, ends swapped if mingaplen is above maxgaplen */
+static void ingest_gap_range(const protocol_t* protocol, uint32_t* mingap, uint32_t* maxgap){
+  *mingap = (protocol->mingaplen < protocol->maxgaplen) ? protocol->mingaplen : protocol->maxgaplen;
+  *maxgap = (protocol->mingaplen < protocol->maxgaplen) ? protocol->maxgaplen : protocol->mingaplen;
+}
+
+/* Silence closing a frame of length pulses, longest gap of protocols of that length */
+static uint32_t ingest_closegap(uint32_t gaplen, uint16_t length){
+  protocol_t** candidates   = NULL;
+  uint16_t     n_candidates = protocol_candidates(length, &candidates);
+  uint32_t     closegap     = gaplen;
+
+  for (uint16_t c = 0; c < n_candidates; c++) {
+    uint32_t mingap, maxgap;
+    ingest_gap_range(candidates[c], &mingap, &maxgap);
+    if (maxgap >= closegap) closegap = maxgap + 1;
+  }
+  return closegap;
+}
+
+/* Silence closing microseconds, with footer of previous frame of the
+   burst if same length. Else candidate protocols of the frame length are tried in order,
+   each one with the middle of its gap range as footer, skipping ranges already tried,
+   until the frame decodes */
+static void ingest_footer(picode_ingest_t* ingest, uint64_t silence){
+
+  uint16_t     length       = ingest->n_frame + 1;
+  uint64_t     footer       = (silence > ingest->gaplen) ? silence : ingest->gaplen;
+  protocol_t** candidates   = NULL;
+  uint16_t     n_candidates = 0;
+  uint32_t     tried_points[INGEST_FOOTER_TRIES];
+  uint16_t     n_tried      = 0;
+
+  if (ingest->n_frame > 0 && ingest->n_frame < ingest->maxlength) {
+    if (length == ingest->burst_length) {
+      footer = ingest->burst_footer;
+    }else{
+      n_candidates = protocol_candidates(length, &candidates);
+    }
+  }
+
+  for (uint16_t c = 0; c < n_candidates; c++) {
+    uint32_t mingap, maxgap;
+    ingest_gap_range(candidates[c], &mingap, &maxgap);
+    if (maxgap == 0) continue;
+
+    // Footer already tried inside this gap range
+    uint32_t point = mingap + (maxgap - mingap) / 2;
+    bool     tried = false;
+    for (uint16_t k = 0; k < n_tried && !tried; k++) {
+      tried = (tried_points[k] >= mingap && tried_points[k] <= maxgap);
+    }
+    if (tried) continue;
+    if (n_tried < INGEST_FOOTER_TRIES) tried_points[n_tried++] = point;
+
+    uint8_t         buffer[INGEST_RESULT_SIZE];
+    picode_result_t result;
+    ingest->frame[ingest->n_frame] = point;
+    if (decodePulseTrainResultMode(ingest->frame, length, PICODE_DECODE_FIRST, &result, buffer, sizeof(buffer)) != 0) {
+      footer = point;
+      break;
+    }
+  }
+
+  ingest_pulse(ingest, footer);
+
+  // Burst ended
+  ingest->burst_length = 0;
+}
+
+/* Silence closing current frame */
+static uint32_t ingest_closegap_of(const picode_ingest_t* ingest){
+  return (ingest->n_frame < ingest->maxlength) ? ingest->closegaps[ingest->n_frame + 1] : ingest->gaplen;
+}
+
+/* Microseconds from stream start to current sample */
+static uint64_t ingest_time(const picode_ingest_t* ingest){
+  return ingest->sample * 1000000 / ingest->sample_rate;
+}
+
+/* Slice one sample */
+static void ingest_sample(picode_ingest_t* ingest, const uint8_t* sample){
+
+  int32_t level = ingest_envelope(ingest, sample) << INGEST_SHIFT;
+
+  if (!ingest->started) {
+    ingest->noise   = level;
+    ingest->carrier = level;
+    ingest->started = true;
+  }
+
+  int32_t margin = (ingest->carrier - ingest->noise) / 2;
+  if (margin < ingest->noise) margin = ingest->noise;
+  if (margin < INGEST_MIN_MARGIN) margin = INGEST_MIN_MARGIN;
+
+  int32_t threshold  = ingest->noise + margin;
+  int32_t hysteresis = margin / 4;
+
+  if (ingest->on) {
+    ingest->carrier += (level - ingest->carrier) >> 3;
+    if (level < threshold - hysteresis) {
+      // Carrier off edge ends a carrier on pulse
+      uint64_t now = ingest_time(ingest);
+      ingest_pulse(ingest, now - ingest->edge);
+      ingest->edge = now;
+      ingest->on   = false;
+    }
+  }else{
+    ingest->noise   += (level - ingest->noise) >> 8;
+    ingest->carrier -= (ingest->carrier - ingest->noise) >> 14;
+    if (level > threshold + hysteresis) {
+      // Carrier on edge ends a carrier off pulse, unless silence was already passed as footer
+      uint64_t now = ingest_time(ingest);
+      if (!ingest->idle) ingest_pulse(ingest, now - ingest->edge);
+      ingest->edge = now;
+      ingest->on   = true;
+      ingest->idle = false;
+      if (level > ingest->carrier) ingest->carrier = level;
+    }else if (!ingest->idle && ingest_time(ingest) - ingest->edge >= ingest_closegap_of(ingest)) {
+      ingest_footer(ingest, ingest_time(ingest) - ingest->edge);
+      ingest_flush_pulses(ingest);
+      ingest->idle = true;
+    }
+  }
+
+  ingest->sample++;
+}
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Create a sample ingest of sample_rate samples per second in PICODE_SAMPLE_* format.
+   Callback is called for each frame like picode_segmenter_new(). Must be picode_ingest_free() after use */
+picode_ingest_t* picode_ingest_new(uint32_t sample_rate, uint8_t format, picode_frame_cb callback, void* userdata){
+
+  picode_ingest_t* ingest = NULL;
+
+  if (sample_rate == 0 || ingest_sample_size(format) == 0 || callback == NULL) return NULL;
+
+  ingest = (picode_ingest_t*)calloc(1, sizeof(picode_ingest_t));
+  if (ingest == NULL) return NULL;
+
+  ingest->segmenter   = picode_segmenter_new(0, callback, userdata);
+  ingest->sample_rate = sample_rate;
+  ingest->format      = format;
+  ingest->sample_size = ingest_sample_size(format);
+  ingest->idle        = true;
+  ingest->maxlength   = protocol_maxrawlen();
+  ingest->frame       = (uint32_t*)calloc((size_t)ingest->maxlength + 1, sizeof(uint32_t));
+  ingest->closegaps   = (uint32_t*)calloc((size_t)ingest->maxlength + 1, sizeof(uint32_t));
+
+  if (ingest->segmenter == NULL || ingest->frame == NULL || ingest->closegaps == NULL){
+    picode_ingest_free(ingest);
+    return NULL;
+  }
+
+  // Silence ending a frame at segmenter, and silence closing it by length
+  ingest->gaplen = picode_segmenter_gaplen(ingest->segmenter);
+
+  for (uint16_t length = 1; length <= ingest->maxlength; length++) {
+    ingest->closegaps[length] = ingest_closegap(ingest->gaplen, length);
+  }
+
+  return ingest;
+}
+
+/* Free sample ingest created by picode_ingest_new(), pending pulses are discarded */
+void picode_ingest_free(picode_ingest_t* ingest){
+  if (ingest != NULL){
+    picode_segmenter_free(ingest->segmenter);
+    free(ingest->frame);
+    free(ingest->closegaps);
+    free(ingest);
+  }
+}
+
+/* Feed a chunk of size bytes of samples, a sample may be split across chunks.
+   Returns number of frames passed to callback */
+int picode_ingest_feed(picode_ingest_t* ingest, const void* samples, size_t size){
+
+  const uint8_t* data = (const uint8_t*)samples;
+
+  if (ingest == NULL || samples == NULL) return 0;
+
+  ingest->frames = 0;
+
+  // Complete sample split by previous chunk
+  if (ingest->n_partial > 0) {
+    size_t copy = ingest->sample_size - ingest->n_partial;
+    if (copy > size) copy = size;
+    memcpy(ingest->partial + ingest->n_partial, data, copy);
+    ingest->n_partial += copy;
+    data += copy;
+    size -= copy;
+    if (ingest->n_partial < ingest->sample_size) return 0;
+    ingest_sample(ingest, ingest->partial);
+    ingest->n_partial = 0;
+  }
+
+  for (; size >= ingest->sample_size; size -= ingest->sample_size, data += ingest->sample_size) {
+    ingest_sample(ingest, data);
+  }
+
+  memcpy(ingest->partial, data, size);
+  ingest->n_partial = size;
+
+  ingest_flush_pulses(ingest);
+
+  return ingest->frames;
+}
+
+/* End of stream, pending pulses are passed with a footer. Returns number of frames passed to callback */
+int picode_ingest_finish(picode_ingest_t* ingest){
+
+  if (ingest == NULL) return 0;
+
+  ingest->frames = 0;
+
+  if (!ingest->idle) {
+    uint64_t now = ingest_time(ingest);
+    if (ingest->on) {
+      ingest_pulse(ingest, now - ingest->edge);
+      ingest_footer(ingest, 0);
+    }else{
+      ingest_footer(ingest, now - ingest->edge);
+    }
+  }
+  ingest_flush_pulses(ingest);
+
+  ingest->on        = false;
+  ingest->idle      = true;
+  ingest->n_partial = 0;
+
+  return ingest->frames;
+}
+
+/* Feed all samples read from file descriptor until end of file, and finish stream.
+   Returns number of frames passed to callback, or -1 on read error */
+int64_t picode_ingest_fd(picode_ingest_t* ingest, int fd){
+
+  int64_t  frames = 0;
+  uint8_t* buffer = NULL;
+
+  if (ingest == NULL || fd < 0) return -1;
+
+  buffer = (uint8_t*)malloc(INGEST_READ_SIZE);
+  if (buffer == NULL) return -1;
+
+  for (;;) {
+#ifdef _WIN32
+    int size = _read(fd, buffer, INGEST_READ_SIZE);
+#else
+    ssize_t size = read(fd, buffer, INGEST_READ_SIZE);
+#endif
+    if (size < 0) {
+      if (errno == EINTR) continue;
+      frames = -1;
+      break;
+    }
+    if (size == 0) {
+      frames += picode_ingest_finish(ingest);
+      break;
+    }
+    frames += picode_ingest_feed(ingest, buffer, (size_t)size);
+  }
+
+  free(buffer);
+
+  return frames;
+}
@@ -0,0 +1,370 @@
+/*
+    PiCode Library
+
+    Prepared encoders for pure C PiCode library.
+
+    A prepared encoder is a protocol, the fixed parameters of a device,
+    like its id, and default values of its variable parameters, like unit
+    and on/off. The default command is encoded once as a template. Each
+    variable parameter is a slot: the first time a slot takes another
+    value, like "off" instead of "on" or another unit, that command is
+    fully encoded and the pulses differing from the template are kept as
+    a patch. Later commands are the template plus the patches of their
+    slots. Commands changing several slots are fully encoded once to check
+    their patches add up, protocols with checksums or encryption across
+    fields fall back to full encodes. Patches changing the frame length
+    or overlapping other patches fall back too, as do all commands of
+    protocols picking an option at random when it is not a parameter.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <string.h>          /* strlen(), memcpy(), etc. */
+#include <stdlib.h>          /* malloc(), free(), etc.   */
+#include <stdbool.h>         /* bool                     */
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+
+/* Pulses of a slot value differing from template */
+typedef struct picode_patch_t {
+  picode_field_t          field;     /* Slot value, key and string owned    */
+  uint32_t                id;        /* Number of patch in prepared encoder */
+  bool                    valid;     /* Same frame length as template       */
+  uint16_t                n_pulses;
+  uint16_t*               positions;
+  uint32_t*               pulses;
+  struct picode_patch_t*  next;      /* Next value of same slot             */
+} picode_patch_t;
+
+/* Checked combination of patches of several slots */
+typedef struct picode_combo_t {
+  uint64_t                key;       /* Hash of patch ids                   */
+  bool                    additive;  /* Patched pulses equal full encode    */
+} picode_combo_t;
+
+struct picode_prepared_t {
+  char*             protocol_name;
+  picode_field_t*   fields;          /* Fixed parameters and slot defaults  */
+  uint16_t          n_fixed;
+  uint16_t          n_slots;
+  picode_field_t*   message;         /* Parameters of current command       */
+  uint32_t*         template_pulses;
+  uint16_t          length;          /* Pulses of template                  */
+  uint16_t          maxrawlen;       /* Longest frame of protocol           */
+  picode_patch_t**  patches;         /* Learnt values of each slot          */
+  uint32_t          n_patches;
+  picode_combo_t*   combos;
+  uint32_t          n_combos;
+  uint32_t          combos_size;
+  uint8_t*          touched;         /* Pulses patched by current command   */
+  uint32_t*         pulses;          /* Pulse buffer for full encodes       */
+  uint16_t          maxlength;
+  bool              random;          /* Option picked at random, no patches */
+  uint64_t          patched;
+  uint64_t          encoded;
+};
+
+/* Aux functions                                                             */
+/* ------------------------------------------------------------------------- */
+
+/* Duplicate string, NULL if out of memory */
+static char* prepared_strdup(const char* str){
+  size_t size = strlen(str) + 1;
+  char*  dup  = (char*)malloc(size);
+  if (dup != NULL) memcpy(dup, str, size);
+  return dup;
+}
+
+/* Check field is a valid parameter */
+static bool field_valid(const picode_field_t* field){
+  if (field->key == NULL) return false;
+  if (field->type == PICODE_FIELD_NUMBER) return true;
+  return (field->type == PICODE_FIELD_STRING && field->string != NULL);
+}
+
+/* Copy field owning its key and string, false if out of memory */
+static bool field_copy(picode_field_t* dst, const picode_field_t* src){
+  *dst = *src;
+  dst->key    = prepared_strdup(src->key);
+  dst->string = (src->type == PICODE_FIELD_STRING) ? prepared_strdup(src->string) : NULL;
+  return (dst->key != NULL && (src->type != PICODE_FIELD_STRING || dst->string != NULL));
+}
+
+/* Free key and string of a field copy */
+static void field_free(picode_field_t* field){
+  free((char*)field->key);
+  free((char*)field->string);
+}
+
+/* Check fields have same key and value */
+static bool field_equal(const picode_field_t* a, const picode_field_t* b){
+  if (a->type != b->type || strcmp(a->key, b->key) != 0) return false;
+  if (a->type == PICODE_FIELD_STRING) return strcmp(a->string, b->string) == 0;
+  return a->number == b->number;
+}
+
+/* Full encode of current message to prepared pulse buffer */
+static int prepared_full_encode(picode_prepared_t* prepared){
+  prepared->encoded++;
+  return encodeToPulseTrainFieldsByName(prepared->pulses, prepared->maxlength, prepared->protocol_name,
+                                        prepared->message, prepared->n_fixed + prepared->n_slots);
+}
+
+/* Find patch of slot value, or learn it with a full encode of that value alone. NULL if encode fails */
+static picode_patch_t* prepared_patch(picode_prepared_t* prepared, uint16_t slot, const picode_field_t* field){
+
+  picode_patch_t* patch = NULL;
+  uint16_t        n     = 0;
+  int             n_pulses;
+
+  for (patch = prepared->patches[slot]; patch != NULL; patch = patch->next) {
+    if (field_equal(&patch->field, field)) return patch;
+  }
+
+  // Template with only this slot changed
+  memcpy(prepared->message, prepared->fields, sizeof(picode_field_t) * (prepared->n_fixed + prepared->n_slots));
+  prepared->message[prepared->n_fixed + slot] = *field;
+
+  n_pulses = prepared_full_encode(prepared);
+  if (n_pulses <= 0) return NULL;
+
+  patch = (picode_patch_t*)calloc(1, sizeof(picode_patch_t));
+  if (patch == NULL) return NULL;
+
+  patch->valid = (n_pulses == prepared->length);
+  if (patch->valid) {
+    for (uint16_t i = 0; i < prepared->length; i++) {
+      if (prepared->pulses[i] != prepared->template_pulses[i]) n++;
+    }
+    patch->positions = (uint16_t*)malloc(sizeof *patch->positions * (n + 1));
+    patch->pulses    = (uint32_t*)malloc(sizeof *patch->pulses * (n + 1));
+  }
+  if (!field_copy(&patch->field, field) || (patch->valid && (patch->positions == NULL || patch->pulses == NULL))) {
+    field_free(&patch->field);
+    free(patch->positions);
+    free(patch->pulses);
+    free(patch);
+    return NULL;
+  }
+  if (patch->valid) {
+    for (uint16_t i = 0; i < prepared->length; i++) {
+      if (prepared->pulses[i] != prepared->template_pulses[i]) {
+        patch->positions[patch->n_pulses] = i;
+        patch->pulses[patch->n_pulses++]  = prepared->pulses[i];
+      }
+    }
+  }
+
+  patch->id   = ++prepared->n_patches;
+  patch->next = prepared->patches[slot];
+  prepared->patches[slot] = patch;
+
+  return patch;
+}
+
+/* Find checked combination of patches, NULL if not checked yet */
+static picode_combo_t* prepared_combo(picode_prepared_t* prepared, uint64_t key){
+  for (uint32_t i = 0; i < prepared->n_combos; i++) {
+    if (prepared->combos[i].key == key) return &prepared->combos[i];
+  }
+  return NULL;
+}
+
+/* Remember checked combination of patches */
+static void prepared_add_combo(picode_prepared_t* prepared, uint64_t key, bool additive){
+  if (prepared->n_combos == prepared->combos_size) {
+    uint32_t        size   = prepared->combos_size ? 2 * prepared->combos_size : 16;
+    picode_combo_t* combos = (picode_combo_t*)realloc(prepared->combos, sizeof *combos * size);
+    if (combos == NULL) return;
+    prepared->combos      = combos;
+    prepared->combos_size = size;
+  }
+  prepared->combos[prepared->n_combos].key      = key;
+  prepared->combos[prepared->n_combos].additive = additive;
+  prepared->n_combos++;
+}
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Prepare encoder of protocol name for fixed parameters and defaults of variable parameters.
+   Must be picode_prepared_free() after use, NULL if default command cannot be encoded */
+picode_prepared_t* picode_prepare(const char* protocol_name, const picode_field_t* fixed, uint16_t n_fixed, const picode_field_t* variable, uint16_t n_variable){
+
+  picode_prepared_t* prepared = NULL;
+  protocol_t*        protocol = NULL;
+  uint16_t           i;
+  int                n_pulses;
+
+  if (protocol_name == NULL || (fixed == NULL && n_fixed > 0) || (variable == NULL && n_variable > 0)) return NULL;
+  if ((uint32_t)n_fixed + n_variable > UINT16_MAX) return NULL;
+
+  for (i = 0; i < n_fixed; i++) if (!field_valid(&fixed[i])) return NULL;
+  for (i = 0; i < n_variable; i++) if (!field_valid(&variable[i])) return NULL;
+
+  protocol = findProtocol(protocol_name);
+  if (protocol == NULL || protocol->createCode == NULL) return NULL;
+
+  prepared = (picode_prepared_t*)calloc(1, sizeof(picode_prepared_t));
+  if (prepared == NULL) return NULL;
+
+  prepared->maxrawlen = protocol->maxrawlen;
+  prepared->maxlength = (uint16_t)(protocol_maxrawlen() + 1);  // Encoders require a longer array than maxrawlen
+
+  prepared->protocol_name   = prepared_strdup(protocol_name);
+  prepared->fields          = (picode_field_t*)calloc((size_t)n_fixed + n_variable + 1, sizeof(picode_field_t));
+  prepared->message         = (picode_field_t*)calloc((size_t)n_fixed + n_variable + 1, sizeof(picode_field_t));
+  prepared->patches         = (picode_patch_t**)calloc((size_t)n_variable + 1, sizeof(picode_patch_t*));
+  prepared->pulses          = (uint32_t*)calloc(prepared->maxlength, sizeof(uint32_t));
+  prepared->template_pulses = (uint32_t*)calloc(prepared->maxlength, sizeof(uint32_t));
+  prepared->touched         = (uint8_t*)calloc(prepared->maxlength, sizeof(uint8_t));
+
+  if (prepared->protocol_name == NULL || prepared->fields == NULL || prepared->message == NULL || prepared->patches == NULL ||
+      prepared->pulses == NULL || prepared->template_pulses == NULL || prepared->touched == NULL){
+    picode_prepared_free(prepared);
+    return NULL;
+  }
+
+  // Fields copies are owned, counted as soon as copied so they are freed on failure
+  for (i = 0; i < n_fixed + n_variable; i++) {
+    bool copied = field_copy(&prepared->fields[i], (i < n_fixed) ? &fixed[i] : &variable[i - n_fixed]);
+    if (i < n_fixed) prepared->n_fixed++; else prepared->n_slots++;
+    if (!copied){
+      picode_prepared_free(prepared);
+      return NULL;
+    }
+  }
+
+  // Option picked at random by protocol when not given must be picked again each command
+  prepared->random = (protocol->randomopt != NULL);
+  for (i = 0; i < n_fixed + n_variable && prepared->random; i++) {
+    if (strcmp(prepared->fields[i].key, protocol->randomopt) == 0) prepared->random = false;
+  }
+
+  // Template is the default command
+  memcpy(prepared->message, prepared->fields, sizeof(picode_field_t) * (n_fixed + n_variable));
+  n_pulses = prepared_full_encode(prepared);
+  if (n_pulses <= 0){
+    picode_prepared_free(prepared);
+    return NULL;
+  }
+  prepared->length = (uint16_t)n_pulses;
+  memcpy(prepared->template_pulses, prepared->pulses, sizeof(uint32_t) * prepared->length);
+
+  return prepared;
+}
+
+/* Free prepared encoder created by picode_prepare() */
+void picode_prepared_free(picode_prepared_t* prepared){
+  if (prepared != NULL){
+    if (prepared->patches != NULL){
+      for (uint16_t i = 0; i < prepared->n_slots; i++) {
+        picode_patch_t* patch = prepared->patches[i];
+        while (patch != NULL) {
+          picode_patch_t* next = patch->next;
+          field_free(&patch->field);
+          free(patch->positions);
+          free(patch->pulses);
+          free(patch);
+          patch = next;
+        }
+      }
+    }
+    if (prepared->fields != NULL){
+      for (uint16_t i = 0; i < prepared->n_fixed + prepared->n_slots; i++) field_free(&prepared->fields[i]);
+    }
+    free(prepared->protocol_name);
+    free(prepared->fields);
+    free(prepared->message);
+    free(prepared->patches);
+    free(prepared->combos);
+    free(prepared->pulses);
+    free(prepared->template_pulses);
+    free(prepared->touched);
+    free(prepared);
+  }
+}
+
+/* Encode prepared command with values of variable parameters, in the same order given to picode_prepare().
+   Returns number of pulses stored in array of pulses if success, or negative error code like encodeToPulseTrain() */
+int picode_prepared_encode(picode_prepared_t* prepared, const picode_field_t* variable, uint16_t n_variable, uint32_t* pulses, uint16_t maxlength){
+
+  picode_patch_t* patch    = NULL;
+  uint64_t        key      = 14695981039346656037ull;
+  uint16_t        n_changed = 0;
+  bool            patchable = true;
+  uint16_t        i;
+  int             n_pulses;
+
+  if (prepared == NULL || pulses == NULL) return ERROR_UNAVAILABLE_PROTOCOL;
+  if (variable == NULL && n_variable > 0) return ERROR_INVALID_PULSETRAIN_MSG;
+  if (n_variable != prepared->n_slots) return ERROR_INVALID_JSON;
+  if (prepared->maxrawlen >= maxlength) return ERROR_NOT_ENOUGH_PULSES_ARRAY_SIZE;
+
+  for (i = 0; i < n_variable; i++) if (!field_valid(&variable[i])) return ERROR_INVALID_JSON;
+
+  patchable = !prepared->random;
+
+  // Patches of changed slots, a failed slot value fails the command
+  memset(prepared->touched, 0, prepared->length);
+  memcpy(pulses, prepared->template_pulses, sizeof(uint32_t) * prepared->length);
+
+  for (i = 0; i < n_variable && patchable; i++) {
+    if (field_equal(&prepared->fields[prepared->n_fixed + i], &variable[i])) continue;
+    patch = prepared_patch(prepared, i, &variable[i]);
+    if (patch == NULL || !patch->valid) {
+      patchable = false;
+      break;
+    }
+    for (uint16_t j = 0; j < patch->n_pulses; j++) {
+      if (prepared->touched[patch->positions[j]]) patchable = false;
+      prepared->touched[patch->positions[j]] = 1;
+      pulses[patch->positions[j]] = patch->pulses[j];
+    }
+    key = (key ^ patch->id) * 1099511628211ull;
+    n_changed++;
+  }
+
+  if (patchable && n_changed > 1) {
+    picode_combo_t* combo = prepared_combo(prepared, key);
+    if (combo != NULL) {
+      patchable = combo->additive;
+    }else{
+      // First use of this combination, check patches add up
+      memcpy(prepared->message, prepared->fields, sizeof(picode_field_t) * prepared->n_fixed);
+      memcpy(prepared->message + prepared->n_fixed, variable, sizeof(picode_field_t) * n_variable);
+      n_pulses = prepared_full_encode(prepared);
+      if (n_pulses <= 0) return n_pulses;
+      patchable = (n_pulses == prepared->length && memcmp(pulses, prepared->pulses, sizeof(uint32_t) * prepared->length) == 0);
+      prepared_add_combo(prepared, key, patchable);
+      if (!patchable) {
+        memcpy(pulses, prepared->pulses, sizeof(uint32_t) * (size_t)n_pulses);
+      }
+      return n_pulses;
+    }
+  }
+
+  if (patchable) {
+    prepared->patched++;
+    return prepared->length;
+  }
+
+  // Fallback to full encode
+  memcpy(prepared->message, prepared->fields, sizeof(picode_field_t) * prepared->n_fixed);
+  memcpy(prepared->message + prepared->n_fixed, variable, sizeof(picode_field_t) * n_variable);
+  n_pulses = prepared_full_encode(prepared);
+  if (n_pulses > 0) {
+    memcpy(pulses, prepared->pulses, sizeof(uint32_t) * (size_t)n_pulses);
+  }
+  return n_pulses;
+}
+
+/* Get number of commands encoded by patching template, and number of full encodes */
+void picode_prepared_stats(const picode_prepared_t* prepared, uint64_t* patched, uint64_t* encoded){
+  if (patched != NULL) *patched = (prepared != NULL) ? prepared->patched : 0;
+  if (encoded != NULL) *encoded = (prepared != NULL) ? prepared->encoded : 0;
+}
@@ -0,0 +1,140 @@
+/*
+    PiCode Library
+
+    Streaming frame segmenter for pure C PiCode library.
+
+    Continuous captures of pulse durations are split in frames at gap
+    pulses. Any pulse not shorter than the gap length ends the current
+    frame, and is kept as its footer like pilight protocols expect. By
+    default the gap length is the shortest mingaplen of the protocols
+    able to decode, so no frame of a known protocol is cut too early.
+    Pulses are buffered up to the longest protocol frame only, a longer
+    run without gap is dropped as noise until next gap.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdlib.h>          /* malloc(), free(), etc.   */
+#include <stdbool.h>         /* bool                     */
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+
+/* Declared in protocol.h from pilight sources included  */
+extern PROTOCOL_THREAD_LOCAL protocols_t* pilight_protocols;
+
+struct picode_segmenter_t {
+  uint32_t*         pulses;     /* Current frame                          */
+  uint16_t          maxlength;  /* Longest frame of any protocol          */
+  uint16_t          minlength;  /* Shortest frame of any protocol         */
+  uint16_t          length;     /* Pulses of current frame                */
+  uint32_t          gaplen;     /* Shortest pulse ending a frame          */
+  bool              overflow;   /* Dropping pulses until next gap         */
+  picode_frame_cb   callback;
+  void*             userdata;
+};
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Create a frame segmenter, 0 gaplen for shortest protocol gap. Must be picode_segmenter_free() after use */
+picode_segmenter_t* picode_segmenter_new(uint32_t gaplen, picode_frame_cb callback, void* userdata){
+
+  picode_segmenter_t* segmenter = NULL;
+  protocols_t*        pnode     = NULL;
+  uint16_t            minlength = 0;
+  uint32_t            mingaplen = 0;
+
+  if (callback == NULL) return NULL;
+
+  if (pilight_protocols == NULL){protocol_init();}
+
+  // Shortest frame and shortest gap of protocols able to decode
+  for (pnode = pilight_protocols; pnode != NULL; pnode = pnode->next) {
+    protocol_t* protocol = pnode->listener;
+    if (protocol->parseCode == NULL || protocol->validate == NULL) continue;
+    if (protocol->minrawlen > 0 && (minlength == 0 || protocol->minrawlen < minlength)) {
+      minlength = (uint16_t)protocol->minrawlen;
+    }
+    if (protocol->mingaplen > 0 && (mingaplen == 0 || (uint32_t)protocol->mingaplen < mingaplen)) {
+      mingaplen = (uint32_t)protocol->mingaplen;
+    }
+  }
+
+  segmenter = (picode_segmenter_t*)malloc(sizeof(picode_segmenter_t));
+  if (segmenter == NULL) return NULL;
+
+  segmenter->maxlength = protocol_maxrawlen();
+  segmenter->minlength = (minlength > 0) ? minlength : 1;
+  segmenter->length    = 0;
+  segmenter->gaplen    = (gaplen > 0) ? gaplen : mingaplen;
+  segmenter->overflow  = false;
+  segmenter->callback  = callback;
+  segmenter->userdata  = userdata;
+  segmenter->pulses    = (uint32_t*)malloc(sizeof *segmenter->pulses * segmenter->maxlength);
+
+  if (segmenter->pulses == NULL || segmenter->gaplen == 0){
+    free(segmenter->pulses);
+    free(segmenter);
+    return NULL;
+  }
+
+  return segmenter;
+}
+
+/* Free segmenter created by picode_segmenter_new(), pending pulses are discarded */
+void picode_segmenter_free(picode_segmenter_t* segmenter){
+  if (segmenter != NULL){
+    free(segmenter->pulses);
+    free(segmenter);
+  }
+}
+
+/* Discard pending pulses, next pulse starts a new frame */
+void picode_segmenter_reset(picode_segmenter_t* segmenter){
+  if (segmenter != NULL){
+    segmenter->length   = 0;
+    segmenter->overflow = false;
+  }
+}
+
+/* Get gap length used to end frames */
+uint32_t picode_segmenter_gaplen(const picode_segmenter_t* segmenter){
+  return (segmenter != NULL) ? segmenter->gaplen : 0;
+}
+
+/* Feed a chunk of pulse durations, callback is called for each complete frame.
+   Returns number of frames passed to callback */
+int picode_segmenter_feed(picode_segmenter_t* segmenter, const uint32_t* pulses, size_t count){
+
+  int frames = 0;
+
+  if (segmenter == NULL || pulses == NULL) return 0;
+
+  for (size_t i = 0; i < count; i++) {
+
+    if (!segmenter->overflow) {
+      if (segmenter->length < segmenter->maxlength) {
+        segmenter->pulses[segmenter->length++] = pulses[i];
+      }else{
+        // Too long for any protocol, drop until next gap
+        segmenter->overflow = true;
+        segmenter->length   = 0;
+      }
+    }
+
+    if (pulses[i] >= segmenter->gaplen) {
+      if (!segmenter->overflow && segmenter->length >= segmenter->minlength) {
+        segmenter->callback(segmenter->pulses, segmenter->length, segmenter->userdata);
+        frames++;
+      }
+      segmenter->length   = 0;
+      segmenter->overflow = false;
+    }
+  }
+
+  return frames;
+}
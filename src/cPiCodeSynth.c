@@ -0,0 +1,214 @@
+/*
+    PiCode Library
+
+    OOK baseband synthesizer for pure C PiCode library.
+
+    Pulse trains are sent as on-off keying: even pulses are carrier on,
+    odd pulses carrier off, the last one being the frame footer. Samples
+    are generated at the carrier frequency, so a carrier on sample is the
+    full scale amplitude at 0 Hz. Each pulse edge is placed at the sample
+    of its exact time from the start of the stream, so no rounding error
+    accumulates along long streams. Samples are passed in chunks to a
+    callback and the whole waveform is never stored.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <string.h>          /* memset(), memcpy()       */
+#include <errno.h>           /* errno, EINTR             */
+#include <stdbool.h>         /* bool                     */
+
+#ifdef _WIN32
+#include <io.h>              /* _write()                 */
+#else
+#include <unistd.h>          /* write()                  */
+#endif
+
+#include "cPiCode.h"         /* Pure C PiCode library .h */
+
+/* Bytes of samples passed to callback on each call */
+#define SYNTH_CHUNK_SIZE      16384
+
+/* Chunked output of samples */
+typedef struct synth_out_t {
+  uint8_t            buffer[SYNTH_CHUNK_SIZE];
+  size_t             used;            /* Bytes of buffer used             */
+  size_t             sample_size;     /* Bytes of a sample                */
+  uint8_t            high[8];         /* Carrier on sample                */
+  uint8_t            low[8];          /* Carrier off sample               */
+  uint64_t           time;            /* Microseconds from stream start   */
+  uint64_t           samples;         /* Samples from stream start        */
+  uint32_t           sample_rate;
+  picode_samples_cb  callback;
+  void*              userdata;
+} synth_out_t;
+
+/* Aux functions                                                             */
+/* ------------------------------------------------------------------------- */
+
+/* Set carrier on and off samples of format, false if unknown format */
+static bool synth_format(synth_out_t* out, uint8_t format){
+
+  const float on_f32[2]  = { 1.0f, 0.0f };
+  const float off_f32[2] = { 0.0f, 0.0f };
+
+  switch (format) {
+    case PICODE_SAMPLE_U8:
+      out->sample_size = 1;
+      out->high[0] = 255;
+      out->low[0]  = 0;
+      break;
+    case PICODE_SAMPLE_CS8:
+      out->sample_size = 2;
+      out->high[0] = 127;
+      out->high[1] = 0;
+      out->low[0]  = 0;
+      out->low[1]  = 0;
+      break;
+    case PICODE_SAMPLE_CF32:
+      out->sample_size = sizeof(on_f32);
+      memcpy(out->high, on_f32, sizeof(on_f32));
+      memcpy(out->low, off_f32, sizeof(off_f32));
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+/* Pass buffered samples to callback, false if callback aborts */
+static bool synth_flush(synth_out_t* out){
+  if (out->used > 0) {
+    if (out->callback(out->buffer, out->used, out->userdata) != 0) return false;
+    out->used = 0;
+  }
+  return true;
+}
+
+/* Output carrier on or off for duration microseconds, false if callback aborts */
+static bool synth_level(synth_out_t* out, bool on, uint64_t duration){
+
+  const uint8_t* sample = on ? out->high : out->low;
+  uint64_t       end;
+  uint64_t       n;
+
+  out->time += duration;
+  end = out->time * out->sample_rate / 1000000;
+  n   = end - out->samples;
+  out->samples = end;
+
+  while (n > 0) {
+    size_t room = (SYNTH_CHUNK_SIZE - out->used) / out->sample_size;
+    size_t k    = (n < room) ? (size_t)n : room;
+    if (k == 0) {
+      if (!synth_flush(out)) return false;
+      continue;
+    }
+    if (out->sample_size == 1) {
+      memset(out->buffer + out->used, sample[0], k);
+    }else{
+      // Replicate first sample doubling the copied run
+      size_t bytes = k * out->sample_size;
+      size_t done  = out->sample_size;
+      memcpy(out->buffer + out->used, sample, out->sample_size);
+      while (done < bytes) {
+        size_t copy = (done < bytes - done) ? done : bytes - done;
+        memcpy(out->buffer + out->used + done, out->buffer + out->used, copy);
+        done += copy;
+      }
+    }
+    out->used += k * out->sample_size;
+    n -= k;
+  }
+  return true;
+}
+
+/* Write all bytes to file descriptor, non zero on failure */
+static int synth_write_fd(const void* samples, size_t size, void* userdata){
+
+  int            fd   = *(const int*)userdata;
+  const uint8_t* data = (const uint8_t*)samples;
+
+  while (size > 0) {
+#ifdef _WIN32
+    int written = _write(fd, data, (unsigned int)size);
+#else
+    ssize_t written = write(fd, data, size);
+#endif
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    data += written;
+    size -= (size_t)written;
+  }
+  return 0;
+}
+
+/* Library functions                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Synthesize OOK baseband samples of pulse train sent frames times, with gap microseconds of carrier off after each frame.
+   Samples in PICODE_SAMPLE_* format are passed in chunks to callback, a non zero return aborts.
+   Returns number of samples, or ERROR_INVALID_SYNTH_PARAMS or ERROR_SYNTH_OUTPUT */
+int64_t picode_synth(const uint32_t* pulses, uint16_t length, uint16_t frames, uint32_t gap, uint32_t sample_rate, uint8_t format, picode_samples_cb callback, void* userdata){
+
+  synth_out_t out;
+
+  if (pulses == NULL || length == 0 || frames == 0 || sample_rate == 0 || callback == NULL) return ERROR_INVALID_SYNTH_PARAMS;
+
+  out.used        = 0;
+  out.time        = 0;
+  out.samples     = 0;
+  out.sample_rate = sample_rate;
+  out.callback    = callback;
+  out.userdata    = userdata;
+
+  if (!synth_format(&out, format)) return ERROR_INVALID_SYNTH_PARAMS;
+
+  for (uint16_t frame = 0; frame < frames; frame++) {
+    for (uint16_t i = 0; i < length; i++) {
+      if (!synth_level(&out, (i % 2) == 0, pulses[i])) return ERROR_SYNTH_OUTPUT;
+    }
+    if (gap > 0 && !synth_level(&out, false, gap)) return ERROR_SYNTH_OUTPUT;
+  }
+
+  if (!synth_flush(&out)) return ERROR_SYNTH_OUTPUT;
+
+  return (int64_t)out.samples;
+}
+
+/* Dito, samples written to file descriptor */
+int64_t picode_synth_fd(const uint32_t* pulses, uint16_t length, uint16_t frames, uint32_t gap, uint32_t sample_rate, uint8_t format, int fd){
+  if (fd < 0) return ERROR_INVALID_SYNTH_PARAMS;
+  return picode_synth(pulses, length, frames, gap, sample_rate, format, synth_write_fd, &fd);
+}
+
+/* Encode from protocol name and json data, and synthesize it sent protocol txrpt times.
+   Returns number of samples, or encodeToPulseTrain() error code, or ERROR_INVALID_SYNTH_PARAMS or ERROR_SYNTH_OUTPUT,
+   or ERROR_SYNTH_OUT_OF_MEMORY */
+int64_t picode_synth_encode(const char* protocol_name, const char* json_data, uint32_t gap, uint32_t sample_rate, uint8_t format, picode_samples_cb callback, void* userdata){
+
+  picode_ctx_t* ctx      = picode_ctx_new();
+  protocol_t*   protocol = NULL;
+  int64_t       result   = ERROR_UNAVAILABLE_PROTOCOL;
+
+  if (ctx == NULL) return ERROR_SYNTH_OUT_OF_MEMORY;
+
+  int n_pulses = picode_encode_ctx(ctx, protocol_name, json_data);
+
+  if (n_pulses > 0) {
+    protocol = findProtocol(protocol_name);
+    result = picode_synth(ctx->pulses, (uint16_t)n_pulses, (protocol->txrpt > 0) ? (uint16_t)protocol->txrpt : 1, gap, sample_rate, format, callback, userdata);
+  }else{
+    result = n_pulses;
+  }
+
+  picode_ctx_free(ctx);
+
+  return result;
+}
@@ -0,0 +1,93 @@
+/*
+    PiCode Library
+
+    Minimal portable threads layer used internally by pure C PiCode library.
+    POSIX threads or Windows threads depending on platform.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#ifndef CPICODE_THREADS_H
+#define CPICODE_THREADS_H
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+typedef HANDLE              picode_thread_t;
+typedef CRITICAL_SECTION    picode_mutex_t;
+typedef CONDITION_VARIABLE  picode_cond_t;
+
+static inline int picode_thread_create(picode_thread_t* thread, DWORD (WINAPI *routine)(LPVOID), void* arg){
+  *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+  return (*thread == NULL) ? -1 : 0;
+}
+
+static inline void picode_thread_join(picode_thread_t thread){
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+#define PICODE_THREAD_ROUTINE(name, arg)  DWORD WINAPI name(LPVOID arg)
+#define PICODE_THREAD_RETURN              return 0
+
+#define picode_mutex_init(m)         InitializeCriticalSection(m)
+#define picode_mutex_destroy(m)      DeleteCriticalSection(m)
+#define picode_mutex_lock(m)         EnterCriticalSection(m)
+#define picode_mutex_unlock(m)       LeaveCriticalSection(m)
+
+#define picode_cond_init(c)          InitializeConditionVariable(c)
+#define picode_cond_destroy(c)       ((void)(c))
+#define picode_cond_wait(c, m)       SleepConditionVariableCS(c, m, INFINITE)
+#define picode_cond_broadcast(c)     WakeAllConditionVariable(c)
+
+/* Get number of online processors */
+static inline unsigned int picode_cpu_count(void){
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (info.dwNumberOfProcessors > 0) ? (unsigned int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_t           picode_thread_t;
+typedef pthread_mutex_t     picode_mutex_t;
+typedef pthread_cond_t      picode_cond_t;
+
+static inline int picode_thread_create(picode_thread_t* thread, void* (*routine)(void*), void* arg){
+  return pthread_create(thread, NULL, routine, arg);
+}
+
+static inline void picode_thread_join(picode_thread_t thread){
+  pthread_join(thread, NULL);
+}
+
+#define PICODE_THREAD_ROUTINE(name, arg)  void* name(void* arg)
+#define PICODE_THREAD_RETURN              return NULL
+
+#define picode_mutex_init(m)         pthread_mutex_init(m, NULL)
+#define picode_mutex_destroy(m)      pthread_mutex_destroy(m)
+#define picode_mutex_lock(m)         pthread_mutex_lock(m)
+#define picode_mutex_unlock(m)       pthread_mutex_unlock(m)
+
+#define picode_cond_init(c)          pthread_cond_init(c, NULL)
+#define picode_cond_destroy(c)       pthread_cond_destroy(c)
+#define picode_cond_wait(c, m)       pthread_cond_wait(c, m)
+#define picode_cond_broadcast(c)     pthread_cond_broadcast(c)
+
+/* Get number of online processors */
+static inline unsigned int picode_cpu_count(void){
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return (n > 0) ? (unsigned int)n : 1;
+}
+
+#endif
+
+#endif
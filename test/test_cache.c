@@ -0,0 +1,137 @@
+/*
+    PiCode Library
+
+    Test of decode cache: jittered repeats of 48 encoded frames are
+    decoded by a 16 entries cache and directly, and both results must
+    match, also after the protocol filter of the thread changes and for
+    footers at both sides of protocol gap range ends. Hit rate of the
+    cache is printed. Frames of arctech_dimmer are left out, since its
+    long pulse is the parse threshold of arctech_contact, so its direct
+    decode changes with jitter and no cache can match it.
+
+    Usage: test_cache [bursts]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf(), snprintf()     */
+#include <stdlib.h>          /* free(), rand(), atol()   */
+#include <string.h>          /* strcmp()                 */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+#define TEST_BURSTS   4000
+#define TEST_ENTRIES  16
+#define TEST_JITTER   20       /* Pulse jitter, +/- microseconds  */
+#define TEST_PULSES   1024
+#define TEST_FRAMES   48
+
+static const char* commands[][2] = {
+  { "arctech_switch",     "{\"id\":%d,\"unit\":%d,\"on\":1}"               },
+  { "clarus_switch",      "{\"id\":\"A%d\",\"unit\":%d,\"on\":1}"          },
+  { "elro_800_switch",    "{\"systemcode\":%d,\"unitcode\":%d,\"on\":1}"   },
+  { "pollin",             "{\"systemcode\":%d,\"unitcode\":%d,\"off\":1}"  },
+  { "impuls",             "{\"systemcode\":%d,\"programcode\":%d,\"on\":1}"},
+  { "quigg_gt7000",       "{\"id\":%d,\"unit\":%d,\"on\":1}"               },
+};
+
+#define N_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+static uint32_t frames[TEST_FRAMES][TEST_PULSES];
+static uint16_t lengths[TEST_FRAMES];
+
+/* Decode by cache and directly, counting a failure if results differ */
+static int test_decode(picode_cache_t* cache, const uint32_t* pulses, uint16_t length, const char* what){
+  const char* cached = picode_cache_decode(cache, pulses, length);
+  char*       direct = decodePulseTrain(pulses, length, "");
+  int         failed = (cached == NULL || direct == NULL || strcmp(cached, direct) != 0);
+  if (failed) printf("FAIL %s: cached %s, direct %s\n", what, cached ? cached : "NULL", direct ? direct : "NULL");
+  free(direct);
+  return failed;
+}
+
+/* Decode bursts of 1 to 10 jittered repeats of random frames */
+static int test_bursts(picode_cache_t* cache, long bursts, const char* what){
+  uint32_t pulses[TEST_PULSES];
+  int      failed = 0;
+
+  for (long b = 0; b < bursts; b++) {
+    int frame   = rand() % TEST_FRAMES;
+    int repeats = 1 + rand() % 10;
+    for (int r = 0; r < repeats; r++) {
+      for (uint16_t p = 0; p < lengths[frame]; p++) {
+        pulses[p] = frames[frame][p] - TEST_JITTER + (uint32_t)(rand() % (2 * TEST_JITTER + 1));
+      }
+      failed += test_decode(cache, pulses, lengths[frame], what);
+    }
+  }
+  return failed;
+}
+
+int main(int argc, char** argv){
+
+  long               bursts = (argc > 1) ? atol(argv[1]) : TEST_BURSTS;
+  picode_cache_t*    cache  = NULL;
+  protocol_filter_t  filter;
+  uint64_t           hits   = 0, misses = 0;
+  int                failed = 0;
+
+  if (bursts <= 0) bursts = TEST_BURSTS;
+
+  // Frames of each command with different ids and units
+  for (int f = 0; f < TEST_FRAMES; f++) {
+    char json[128];
+    size_t c = (size_t)f % N_COMMANDS;
+    snprintf(json, sizeof(json), commands[c][1], 1 + (f * 7) % 31, f % 4);
+    int length = encodeToPulseTrainByName(frames[f], TEST_PULSES, commands[c][0], json);
+    if (length <= 0) {
+      printf("ERROR: unable to encode %s %s\n", commands[c][0], json);
+      return EXIT_FAILURE;
+    }
+    lengths[f] = (uint16_t)length;
+  }
+
+  cache = picode_cache_new(TEST_ENTRIES, "");
+  if (cache == NULL) return EXIT_FAILURE;
+
+  srand(1);
+  failed += test_bursts(cache, bursts, "repeats");
+
+  // Results of all protocols must not be answered once filtered, and back
+  protocol_filter_clear(&filter);
+  protocol_filter_add(&filter, "arctech_switch");
+  protocol_filter_set(&filter);
+  failed += test_bursts(cache, bursts / 4, "filtered");
+  protocol_filter_set(NULL);
+  failed += test_bursts(cache, bursts / 4, "unfiltered");
+
+  // Footers inside and just outside gap range of each protocol of frame length, same pulse type
+  for (int f = 0; f < TEST_FRAMES; f++) {
+    protocol_t** candidates   = NULL;
+    uint16_t     n_candidates = protocol_candidates(lengths[f], &candidates);
+    for (uint16_t c = 0; c < n_candidates; c++) {
+      uint32_t ends[2] = { candidates[c]->mingaplen, candidates[c]->maxgaplen };
+      if (ends[1] == 0) continue;
+      for (int e = 0; e < 2; e++) {
+        for (int delta = -1; delta <= 1; delta++) {
+          frames[f][lengths[f] - 1] = ends[e] + (uint32_t)delta;
+          failed += test_decode(cache, frames[f], lengths[f], "footer");
+        }
+      }
+    }
+  }
+
+  picode_cache_stats(cache, &hits, &misses);
+  printf("%llu hits, %llu misses, %.0f%% hit rate\n", (unsigned long long)hits, (unsigned long long)misses,
+         100.0 * (double)hits / (double)(hits + misses));
+  printf("%s: %d failed\n", failed == 0 ? "OK" : "FAIL", failed);
+
+  picode_cache_free(cache);
+  picode_shutdown();
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,116 @@
+/*
+    PiCode Library
+
+    Round trip test of OOK synthesizer and SDR sample ingest: commands
+    encoded, synthesized as baseband samples sent 1 to 3 times, and
+    ingested back, must decode once for each frame sent, last frame of
+    the burst included. A single frame has no real gap to tell apart
+    protocols of same length, so it must just decode to some protocol.
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf()                 */
+#include <stdlib.h>          /* free()                   */
+#include <string.h>          /* strstr()                 */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+typedef struct test_command_t {
+  const char* protocol;
+  const char* json;
+} test_command_t;
+
+static const test_command_t commands[] = {
+  { "arctech_switch",     "{\"id\":92,\"unit\":0,\"on\":1}"                },
+  { "arctech_dimmer",     "{\"id\":92,\"unit\":0,\"dimlevel\":7}"          },
+  { "elro_800_switch",    "{\"systemcode\":17,\"unitcode\":1,\"on\":1}"    },
+  { "pollin",             "{\"systemcode\":17,\"unitcode\":1,\"off\":1}"   },
+  { "impuls",             "{\"systemcode\":17,\"programcode\":1,\"on\":1}" },
+  { "quigg_gt7000",       "{\"id\":1234,\"unit\":1,\"on\":1}"              },
+  { "rev1_switch",        "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+  { "clarus_switch",      "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+};
+
+static const uint8_t formats[] = { PICODE_SAMPLE_U8, PICODE_SAMPLE_CS8, PICODE_SAMPLE_CF32 };
+
+#define TEST_SAMPLE_RATE 250000
+
+/* Silence before first frame, 10 ms, so noise floor starts at carrier off level.
+   Zero bytes are carrier off in all tested formats */
+#define TEST_SILENCE     (TEST_SAMPLE_RATE / 100)
+
+static const uint8_t silence[TEST_SILENCE * 2 * sizeof(float)];
+
+typedef struct test_run_t {
+  picode_ingest_t* ingest;
+  const char*      protocol;
+  int              decoded;         /* Frames decoded as protocol        */
+  int              matched;         /* Frames decoded as any protocol    */
+} test_run_t;
+
+/* Decode each frame passed by ingest, counting matches of protocol */
+static void test_frame(const uint32_t* pulses, uint16_t length, void* userdata){
+  test_run_t* run = (test_run_t*)userdata;
+  char* json = decodePulseTrain(pulses, length, "");
+  if (json != NULL && strstr(json, run->protocol) != NULL) run->decoded++;
+  if (json != NULL && strstr(json, "{\"protocols\":[]}") == NULL) run->matched++;
+  free(json);
+}
+
+/* Pass synthesized samples to ingest */
+static int test_samples(const void* samples, size_t size, void* userdata){
+  test_run_t* run = (test_run_t*)userdata;
+  picode_ingest_feed(run->ingest, samples, size);
+  return 0;
+}
+
+int main(void){
+
+  uint32_t pulses[1024];
+  int      failed = 0;
+  int      passed = 0;
+
+  for (size_t c = 0; c < sizeof(commands) / sizeof(commands[0]); c++) {
+
+    int length = encodeToPulseTrainByName(pulses, 1024, commands[c].protocol, commands[c].json);
+    if (length <= 0) {
+      printf("FAIL %s: encode error %d\n", commands[c].protocol, length);
+      failed++;
+      continue;
+    }
+
+    for (size_t f = 0; f < sizeof(formats); f++) {
+      for (uint16_t frames = 1; frames <= 3; frames++) {
+
+        test_run_t run = { NULL, commands[c].protocol, 0, 0 };
+        run.ingest = picode_ingest_new(TEST_SAMPLE_RATE, formats[f], test_frame, &run);
+        picode_ingest_feed(run.ingest, silence, TEST_SILENCE * ((formats[f] == PICODE_SAMPLE_U8) ? 1 : (formats[f] == PICODE_SAMPLE_CS8) ? 2 : 2 * sizeof(float)));
+
+        // Frames repeated with their own footer as gap, then ended by stream end
+        int64_t samples = picode_synth(pulses, (uint16_t)length, frames, 0, TEST_SAMPLE_RATE, formats[f], test_samples, &run);
+        picode_ingest_finish(run.ingest);
+        picode_ingest_free(run.ingest);
+
+        int decoded = (frames == 1) ? run.matched : run.decoded;
+
+        if (samples <= 0 || decoded != frames) {
+          printf("FAIL %s: format %u, %u frames sent, %d decoded\n", commands[c].protocol, formats[f], frames, decoded);
+          failed++;
+        }else{
+          passed++;
+        }
+      }
+    }
+  }
+
+  printf("%d passed, %d failed\n", passed, failed);
+
+  picode_shutdown();
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
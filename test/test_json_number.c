@@ -0,0 +1,124 @@
+/*
+    PiCode Library
+
+    Conformance test of json number output: numbers with 0 to 12
+    decimals are encoded by json_encode() and must match snprintf()
+    "%.*f", or null for not finite numbers and numbers longer than 63
+    chars. Values are integers, protocol-like decimals, values next to
+    half way of last decimal and random bit patterns.
+
+    Usage: test_json_number [random values]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>           /* printf(), snprintf()     */
+#include <stdlib.h>          /* rand(), atol()           */
+#include <string.h>          /* strcmp(), memcpy()       */
+#include <math.h>            /* nextafter(), isfinite()  */
+
+#include "../src/cPiCode.h"  /* Pure C PiCode library .h */
+
+#define TEST_RANDOM    1000000
+#define TEST_DECIMALS  12
+
+static long tested = 0;
+
+/* Encode num with decimals, counting a failure if not as snprintf() */
+static int test_number(double num, int decimals){
+  char      expected[512];
+  int       size   = snprintf(expected, sizeof(expected), "%.*f", decimals, num);
+  JsonNode* node   = json_mknumber(num, decimals);
+  char*     result = (node != NULL) ? json_encode(node) : NULL;
+  int       failed;
+
+  if (!isfinite(num) || size >= 64) strcpy(expected, "null");
+
+  failed = (result == NULL || strcmp(result, expected) != 0);
+  if (failed) printf("FAIL: %.17g with %d decimals, expected %s, result %s\n", num, decimals, expected, result ? result : "NULL");
+
+  json_free(result);
+  json_delete(node);
+  tested++;
+  return failed;
+}
+
+/* Random 64 bits */
+static uint64_t test_bits(void){
+  uint64_t bits = 0;
+  for (int i = 0; i < 4; i++) bits = (bits << 16) | (uint64_t)(rand() & 0xFFFF);
+  return bits;
+}
+
+int main(int argc, char** argv){
+
+  long   random = (argc > 1) ? atol(argv[1]) : TEST_RANDOM;
+  int    failed = 0;
+  double scale  = 1;
+
+  if (random <= 0) random = TEST_RANDOM;
+
+  // Integers, and powers of ten around limit of fast path
+  for (int i = -100000; i <= 100000; i++) {
+    failed += test_number((double)i, i & 3);
+  }
+  for (int p = 0; p <= 22; p++, scale *= 10) {
+    for (int decimals = 0; decimals <= TEST_DECIMALS; decimals++) {
+      failed += test_number(scale, decimals);
+      failed += test_number(-scale - 1, decimals);
+      failed += test_number(scale + 0.5, decimals);
+    }
+  }
+
+  // Protocol-like decimals, like temperatures, humidities and voltages
+  for (int i = -5000; i <= 15000; i++) {
+    failed += test_number(i / 10.0, 1);
+    failed += test_number(i * 0.1, 1);
+    failed += test_number(i / 100.0, 2);
+    failed += test_number(i * 0.01, 2);
+    failed += test_number(i / 1000.0, 3);
+    failed += test_number(i / 100.0, 1);
+  }
+
+  // Half way of last decimal and its neighbours
+  scale = 1;
+  for (int decimals = 0; decimals <= TEST_DECIMALS; decimals++, scale *= 10) {
+    for (int i = -20000; i <= 20000; i++) {
+      double half = (i + 0.5) / scale;
+      failed += test_number(half, decimals);
+      failed += test_number(nextafter(half, -INFINITY), decimals);
+      failed += test_number(nextafter(half,  INFINITY), decimals);
+    }
+  }
+
+  // Special values
+  for (int decimals = 0; decimals <= TEST_DECIMALS; decimals++) {
+    failed += test_number(0.0, decimals);
+    failed += test_number(-0.0, decimals);
+    failed += test_number(INFINITY, decimals);
+    failed += test_number(-INFINITY, decimals);
+    failed += test_number(NAN, decimals);
+    failed += test_number(1e300, decimals);
+  }
+
+  // Random bit patterns, and random values of magnitude up to 1e16
+  srand(1);
+  for (long n = 0; n < random; n++) {
+    uint64_t bits = test_bits();
+    double   num;
+    memcpy(&num, &bits, sizeof(num));
+    failed += test_number(num, (int)(n % (TEST_DECIMALS + 1)));
+    scale = 1e3;
+    for (int p = rand() % 20; p > 0; p--) scale *= 10;
+    num = (double)(int64_t)test_bits() / scale;
+    failed += test_number(num, (int)(n % (TEST_DECIMALS + 1)));
+  }
+
+  printf("%ld numbers, %s: %d failed\n", tested, failed == 0 ? "OK" : "FAIL", failed);
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,104 @@
+/*
+    PiCode Library
+
+    Test of prepared encoders: every unit and state of some devices is
+    encoded by a prepared encoder and must match a full encode of the
+    same command. Commands of protocols picking an option at random,
+    like "num" of quigg_gt1000, must never be patched on the template
+    unless that option is given.
+
+    Usage: test_prepared
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>                   /* printf()                 */
+#include <stdlib.h>                  /* EXIT_SUCCESS             */
+#include <string.h>                  /* memcmp()                 */
+
+#include "../src/cPiCode.h"          /* Pure C PiCode library .h */
+
+#define TEST_PULSES  1024
+
+/* Number field */
+static picode_field_t test_number(const char* key, double number){
+  picode_field_t field = { key, PICODE_FIELD_NUMBER, 0, number, NULL };
+  return field;
+}
+
+/* Encode units and states of device by prepared encoder, counting failures.
+   Full encodes must match if deterministic, patches are expected or not */
+static int test_device(const char* protocol, const picode_field_t* fixed, uint16_t n_fixed, int units, int deterministic, int patches){
+
+  uint32_t           pulses[TEST_PULSES];
+  uint32_t           expected[TEST_PULSES];
+  picode_field_t     variable[2] = { test_number("unit", 0), test_number("on", 1) };
+  picode_field_t     fields[8];
+  picode_prepared_t* prepared    = picode_prepare(protocol, fixed, n_fixed, variable, 2);
+  uint64_t           patched     = 0;
+  uint64_t           encoded     = 0;
+  long               commands    = 0;
+  int                failed      = 0;
+
+  if (prepared == NULL) {
+    printf("FAIL: unable to prepare %s\n", protocol);
+    return 1;
+  }
+
+  for (int unit = 0; unit < units; unit++) {
+    for (int state = 0; state < 2; state++) {
+      variable[0] = test_number("unit", unit);
+      variable[1] = test_number(state ? "on" : "off", 1);
+
+      int length = picode_prepared_encode(prepared, variable, 2, pulses, TEST_PULSES);
+      commands++;
+      if (length <= 0) {
+        printf("FAIL: %s unit %d state %d, error %d\n", protocol, unit, state, length);
+        failed++;
+        continue;
+      }
+      if (!deterministic) continue;
+
+      memcpy(fields, fixed, sizeof(picode_field_t) * n_fixed);
+      memcpy(fields + n_fixed, variable, sizeof(variable));
+      if (encodeToPulseTrainFieldsByName(expected, TEST_PULSES, protocol, fields, n_fixed + 2) != length ||
+          memcmp(pulses, expected, sizeof(uint32_t) * (size_t)length) != 0) {
+        printf("FAIL: %s unit %d state %d, prepared and full encode differ\n", protocol, unit, state);
+        failed++;
+      }
+    }
+  }
+
+  picode_prepared_stats(prepared, &patched, &encoded);
+  printf("%-16s %3ld commands, %3lu patched, %3lu full encodes\n", protocol, commands, (unsigned long)patched, (unsigned long)encoded);
+
+  if (patches ? patched == 0 : (patched != 0 || encoded != (uint64_t)commands + 1)) {
+    printf("FAIL: %s %s\n", protocol, patches ? "never patched" : "patched with option picked at random");
+    failed++;
+  }
+
+  picode_prepared_free(prepared);
+  return failed;
+}
+
+int main(void){
+
+  picode_field_t arctech[1] = { test_number("id", 92) };
+  picode_field_t quigg[1]   = { test_number("id", 1) };
+  picode_field_t quigg_n[2] = { test_number("id", 1), test_number("num", 2) };
+  int            failed     = 0;
+
+  failed += test_device("arctech_switch", arctech, 1, 16, 1, 1);
+  failed += test_device("quigg_gt1000", quigg_n, 2, 4, 1, 1);
+  failed += test_device("quigg_gt1000", quigg, 1, 4, 0, 0);
+
+  printf("%s: %d failed\n", failed == 0 ? "OK" : "FAIL", failed);
+
+  picode_shutdown();
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
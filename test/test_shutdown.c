@@ -0,0 +1,192 @@
+/*
+    PiCode Library
+
+    Test of library lifecycle: cycles of protocols init, encode and decode
+    of some commands, and picode_shutdown(), on main thread and on worker
+    threads ending without shutdown. Every decode must match the one of
+    the first cycle, and once the last thread releases protocols no heap
+    block of the library may be left, shared options and device lists
+    included. On glibc, blocks in use are counted by replacing malloc()
+    family, from before first init, as freed memory kept by allocator
+    caches would hide a leak from heap statistics. Elsewhere, and on
+    sanitizer builds, run it under a leak checker.
+
+    Usage: test_shutdown [cycles]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>                   /* printf()                 */
+#include <stdlib.h>                  /* malloc(), free(), atol() */
+#include <string.h>                  /* strcmp()                 */
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#include <stdatomic.h>               /* atomic_long              */
+
+/* Heap blocks in use, counted by replacing malloc() family of glibc */
+#define TEST_HEAP_BLOCKS() atomic_load(&test_blocks)
+
+static atomic_long test_blocks;
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void  __libc_free(void* ptr);
+
+void* malloc(size_t size){
+  void* ptr = __libc_malloc(size);
+  if (ptr != NULL) atomic_fetch_add(&test_blocks, 1);
+  return ptr;
+}
+
+void* calloc(size_t count, size_t size){
+  void* ptr = __libc_calloc(count, size);
+  if (ptr != NULL) atomic_fetch_add(&test_blocks, 1);
+  return ptr;
+}
+
+void* realloc(void* ptr, size_t size){
+  void* new_ptr = __libc_realloc(ptr, size);
+  if (ptr == NULL && new_ptr != NULL) atomic_fetch_add(&test_blocks, 1);
+  if (ptr != NULL && size == 0) atomic_fetch_sub(&test_blocks, 1);
+  return new_ptr;
+}
+
+void free(void* ptr){
+  if (ptr != NULL) atomic_fetch_sub(&test_blocks, 1);
+  __libc_free(ptr);
+}
+#endif
+
+#include "../src/cPiCode.h"          /* Pure C PiCode library .h */
+#include "../src/cPiCodeThreads.h"   /* Portable threads layer   */
+
+#define TEST_CYCLES   10000
+#define TEST_THREADS  4
+#define TEST_WARMUP   100
+#define TEST_PULSES   1024
+
+static const char* commands[][2] = {
+  { "arctech_switch",     "{\"id\":92,\"unit\":0,\"on\":1}"                },
+  { "arctech_dimmer",     "{\"id\":92,\"unit\":0,\"dimlevel\":7}"          },
+  { "elro_800_switch",    "{\"systemcode\":17,\"unitcode\":1,\"on\":1}"    },
+  { "quigg_gt7000",       "{\"id\":1234,\"unit\":1,\"on\":1}"              },
+  { "kaku_switch",        "{\"id\":92,\"unit\":0,\"off\":1}"               },
+  { "clarus_switch",      "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+};
+
+#define N_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+static char* expected[N_COMMANDS];
+
+/* Init protocols, encode and decode every command and shut down. Returns number of failures */
+static long test_cycle(int shutdown){
+  uint32_t pulses[TEST_PULSES];
+  long     failed = 0;
+
+  if (picode_init() <= 0) failed++;
+
+  for (size_t c = 0; c < N_COMMANDS; c++) {
+    int   length = encodeToPulseTrainByName(pulses, TEST_PULSES, commands[c][0], commands[c][1]);
+    char* result = (length > 0) ? decodePulseTrain(pulses, (uint16_t)length, "") : NULL;
+    if (result == NULL) {
+      failed++;
+    }else if (expected[c] == NULL) {
+      expected[c] = result;
+      continue;
+    }else if (strcmp(result, expected[c]) != 0) {
+      failed++;
+    }
+    free(result);
+  }
+
+  if (shutdown) picode_shutdown();
+  return failed;
+}
+
+typedef struct test_thread_t {
+  picode_thread_t thread;
+  long            cycles;
+  long            failed;
+} test_thread_t;
+
+/* Cycles with shutdown, last one released at thread exit */
+static PICODE_THREAD_ROUTINE(test_worker, arg){
+  test_thread_t* self = (test_thread_t*)arg;
+  for (long n = 0; n < self->cycles; n++) {
+    self->failed += test_cycle(n + 1 < self->cycles);
+  }
+  PICODE_THREAD_RETURN;
+}
+
+/* Nothing, threads only */
+static PICODE_THREAD_ROUTINE(test_idle, arg){
+  PICODE_THREAD_RETURN;
+}
+
+/* Worker threads of cycles each while main thread keeps protocols, then main thread shuts down */
+static long test_threads(long cycles){
+  test_thread_t threads[TEST_THREADS];
+  long          failed = (cycles > 0) ? test_cycle(0) : 0;
+
+  for (int t = 0; t < TEST_THREADS; t++) {
+    threads[t].cycles = cycles;
+    threads[t].failed = 0;
+    if (picode_thread_create(&threads[t].thread, (cycles > 0) ? test_worker : test_idle, &threads[t]) != 0) failed++;
+  }
+  for (int t = 0; t < TEST_THREADS; t++) {
+    picode_thread_join(threads[t].thread);
+    failed += threads[t].failed;
+  }
+  if (cycles > 0) picode_shutdown();
+  return failed;
+}
+
+int main(int argc, char** argv){
+
+  long          cycles = (argc > 1) ? atol(argv[1]) : TEST_CYCLES;
+  long          failed = 0;
+
+  if (cycles <= 0) cycles = TEST_CYCLES;
+
+  printf("%ld cycles\n", cycles);
+
+  // Idle threads first, as runtime keeps some memory of threads ever run
+  failed += test_threads(0);
+
+#ifdef TEST_HEAP_BLOCKS
+  long before = TEST_HEAP_BLOCKS();
+#endif
+
+  // Expected decodes, kept through all cycles, and warm up of main and worker threads
+  for (long n = 0; n < TEST_WARMUP; n++) {
+    failed += test_cycle(1);
+  }
+  failed += test_threads(1);
+
+#ifdef TEST_HEAP_BLOCKS
+  long warmup = TEST_HEAP_BLOCKS() - before;
+#endif
+
+  for (long n = 0; n < cycles; n++) {
+    failed += test_cycle(1);
+  }
+
+  failed += test_threads(cycles / 100 + 1);
+
+#ifdef TEST_HEAP_BLOCKS
+  long after = TEST_HEAP_BLOCKS() - before;
+  printf("heap blocks left after warm up %ld, after last cycle %ld, expected decodes %zu\n", warmup, after, N_COMMANDS);
+  if (warmup != (long)N_COMMANDS || after != (long)N_COMMANDS) failed++;
+#endif
+
+  printf("%s: %ld failed\n", failed == 0 ? "OK" : "FAIL", failed);
+
+  for (size_t c = 0; c < N_COMMANDS; c++) free(expected[c]);
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
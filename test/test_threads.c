@@ -0,0 +1,169 @@
+/*
+    PiCode Library
+
+    Multi-threaded stress test of per thread protocol state: 1, 2, 4 up
+    to max threads decode and encode at once, each one with its own
+    context and no locking, the same number of frames per thread. Every
+    result must match the one of a single thread. Throughput of all
+    threads is printed for each thread count, and its scaling from one
+    thread only while every thread may run on its own processor.
+
+    Usage: test_threads [frames per thread] [max threads]
+
+    https://github.com/latchdevel/PiCode
+
+    Copyright (c) 2021 Jorge Rivera. All right reserved.
+    License GNU Lesser General Public License v3.0.
+
+*/
+
+#include <stdio.h>                   /* printf()                 */
+#include <stdlib.h>                  /* free(), atol()           */
+#include <string.h>                  /* strcmp()                 */
+#include <time.h>                    /* timespec_get()           */
+
+#include "../src/cPiCode.h"          /* Pure C PiCode library .h */
+#include "../src/cPiCodeThreads.h"   /* Portable threads layer   */
+
+#define TEST_FRAMES   20000
+#define TEST_THREADS  8
+#define TEST_PULSES   1024
+
+static const char* commands[][2] = {
+  { "arctech_switch",     "{\"id\":92,\"unit\":0,\"on\":1}"                },
+  { "arctech_dimmer",     "{\"id\":92,\"unit\":0,\"dimlevel\":7}"          },
+  { "elro_800_switch",    "{\"systemcode\":17,\"unitcode\":1,\"on\":1}"    },
+  { "pollin",             "{\"systemcode\":17,\"unitcode\":1,\"off\":1}"   },
+  { "quigg_gt7000",       "{\"id\":1234,\"unit\":1,\"on\":1}"              },
+  { "rev1_switch",        "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+  { "clarus_switch",      "{\"id\":\"A1\",\"unit\":1,\"on\":1}"            },
+};
+
+#define N_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+/* Pulse trains and decoded json of commands, by main thread */
+static uint32_t pulses[N_COMMANDS][TEST_PULSES];
+static uint16_t lengths[N_COMMANDS];
+static char*    expected[N_COMMANDS];
+
+typedef struct test_thread_t {
+  picode_thread_t thread;
+  long            frames;
+  long            errors;
+} test_thread_t;
+
+/* Seconds from an arbitrary point */
+static double test_now(void){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Encode and decode frames with own context, counting results not matching main thread ones */
+static PICODE_THREAD_ROUTINE(test_worker, arg){
+
+  test_thread_t* self = (test_thread_t*)arg;
+  picode_ctx_t*  ctx  = picode_ctx_new();
+
+  if (ctx == NULL) {
+    self->errors = self->frames;
+    PICODE_THREAD_RETURN;
+  }
+
+  for (long n = 0; n < self->frames; n++) {
+    size_t      c      = (size_t)n % N_COMMANDS;
+    const char* result = NULL;
+
+    // Every tenth frame is encoded too, as senders do
+    if (n % 10 == 0) {
+      if (picode_encode_ctx(ctx, commands[c][0], commands[c][1]) != lengths[c] ||
+          memcmp(ctx->pulses, pulses[c], lengths[c] * sizeof(uint32_t)) != 0) {
+        self->errors++;
+      }
+    }
+
+    result = picode_decode_ctx(ctx, pulses[c], lengths[c], "   ");
+    if (result == NULL || strcmp(result, expected[c]) != 0) self->errors++;
+  }
+
+  picode_ctx_free(ctx);
+
+  PICODE_THREAD_RETURN;
+}
+
+int main(int argc, char** argv){
+
+  long          frames      = (argc > 1) ? atol(argv[1]) : TEST_FRAMES;
+  unsigned int  max_threads = (argc > 2) ? (unsigned int)atoi(argv[2]) : TEST_THREADS;
+  test_thread_t threads[64];
+  long          errors      = 0;
+  double        single      = 0;
+
+  if (frames <= 0) frames = TEST_FRAMES;
+  if (max_threads == 0) max_threads = TEST_THREADS;
+  if (max_threads > 64) max_threads = 64;
+
+  picode_ctx_t* ctx = picode_ctx_new();
+  if (ctx == NULL) return EXIT_FAILURE;
+
+  for (size_t c = 0; c < N_COMMANDS; c++) {
+    int length = encodeToPulseTrainByName(pulses[c], TEST_PULSES, commands[c][0], commands[c][1]);
+    const char* result = (length > 0) ? picode_decode_ctx(ctx, pulses[c], (uint16_t)length, "   ") : NULL;
+    if (result == NULL) {
+      printf("ERROR: unable to encode and decode %s\n", commands[c][0]);
+      return EXIT_FAILURE;
+    }
+    lengths[c]  = (uint16_t)length;
+    expected[c] = (char*)malloc(strlen(result) + 1);
+    if (expected[c] == NULL) return EXIT_FAILURE;
+    strcpy(expected[c], result);
+  }
+  picode_ctx_free(ctx);
+
+  unsigned int processors = picode_cpu_count();
+
+  printf("%ld frames per thread, %u processors\n", frames, processors);
+
+  for (unsigned int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+
+    unsigned int started = 0;
+    long         run_errors = 0;
+    double       start = test_now();
+
+    for (unsigned int t = 0; t < n_threads; t++) {
+      threads[t].frames = frames;
+      threads[t].errors = 0;
+      if (picode_thread_create(&threads[t].thread, test_worker, &threads[t]) != 0) break;
+      started++;
+    }
+    for (unsigned int t = 0; t < started; t++) {
+      picode_thread_join(threads[t].thread);
+      run_errors += threads[t].errors;
+    }
+
+    double elapsed = test_now() - start;
+    double rate    = (double)frames * started / elapsed;
+    if (n_threads == 1) single = rate;
+
+    if (started <= processors) {
+      printf("%2u threads %10.0f frames/s  x%5.2f  efficiency %3.0f%%  %ld errors\n",
+             started, rate, rate / single, 100.0 * rate / (single * started), run_errors);
+    }else{
+      printf("%2u threads %10.0f frames/s  more threads than processors  %ld errors\n",
+             started, rate, run_errors);
+    }
+
+    if (started < n_threads) {
+      printf("ERROR: unable to start %u threads\n", n_threads);
+      run_errors++;
+    }
+    errors += run_errors;
+  }
+
+  printf("%s\n", errors == 0 ? "OK" : "FAIL");
+
+  for (size_t c = 0; c < N_COMMANDS; c++) free(expected[c]);
+  picode_shutdown();
+
+  return (errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}